@@ -0,0 +1,76 @@
+#include "benchmark.h"
+
+#include <algorithm>
+
+BenchmarkRunner::BenchmarkRunner(std::ostream& output, const Options& options) :
+mOutput(output), mOptions(options) {
+
+}
+
+bool BenchmarkRunner::isSelected(const std::string& name) const {
+	return mOptions.filter.empty() || name.find(mOptions.filter) != std::string::npos;
+}
+
+// Every sample runs the body the calibrated number of times; the median sample is reported alongside the fastest
+void BenchmarkRunner::run(const std::string& name, std::size_t itemCount, const body_t& body, const setup_t& setup) {
+	if (!isSelected(name))
+		return;
+	std::size_t iterations = calibrate(body, setup);
+	std::vector<double> sampleNs;
+	for (int s = 0; s < std::max(1, mOptions.samples); s++)
+		sampleNs.push_back((double)runIterations(body, setup, iterations).count());
+	std::sort(sampleNs.begin(), sampleNs.end());
+	double perItem = (double)iterations * std::max((std::size_t)1, itemCount);
+	writeResult({ name, itemCount, iterations, sampleNs[sampleNs.size() / 2] / perItem, sampleNs.front() / perItem });
+}
+
+std::uint64_t BenchmarkRunner::getChecksum() const {
+	return mChecksum;
+}
+
+// Doubles the iteration count until one sample takes at least minSampleTime, which also warms caches and the pool
+std::size_t BenchmarkRunner::calibrate(const body_t& body, const setup_t& setup) {
+	for (std::size_t iterations = 1;; iterations *= 2)
+		if (runIterations(body, setup, iterations) >= mOptions.minSampleTime)
+			return iterations;
+}
+
+// Without a setup the iterations are timed as one block; with one, only the body calls are timed and summed
+std::chrono::nanoseconds BenchmarkRunner::runIterations(const body_t& body, const setup_t& setup, std::size_t iterations) {
+	if (!setup) {
+		auto start = std::chrono::steady_clock::now();
+		for (std::size_t i = 0; i < iterations; i++)
+			mChecksum += body();
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+	}
+	std::chrono::nanoseconds elapsed(0);
+	for (std::size_t i = 0; i < iterations; i++) {
+		setup();
+		auto start = std::chrono::steady_clock::now();
+		mChecksum += body();
+		elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+	}
+	return elapsed;
+}
+
+void BenchmarkRunner::writeHeader() {
+	if (mOptions.format == Csv)
+		mOutput << "name,items,iterations,median_ns_per_item,min_ns_per_item,items_per_second\n";
+	mHasWrittenHeader = true;
+}
+
+// JSON output is one object per line, so results can be appended to and streamed from a log
+void BenchmarkRunner::writeResult(const Result& result) {
+	if (!mHasWrittenHeader)
+		writeHeader();
+	double itemsPerSecond = (result.medianNs > 0) ? 1e9 / result.medianNs : 0;
+	if (mOptions.format == Csv) {
+		mOutput << result.name << ',' << result.itemCount << ',' << result.iterations << ','
+			<< result.medianNs << ',' << result.minNs << ',' << itemsPerSecond << '\n';
+	} else {
+		mOutput << "{\"name\":\"" << result.name << "\",\"items\":" << result.itemCount << ",\"iterations\":" << result.iterations
+			<< ",\"median_ns_per_item\":" << result.medianNs << ",\"min_ns_per_item\":" << result.minNs
+			<< ",\"items_per_second\":" << itemsPerSecond << "}\n";
+	}
+	mOutput.flush();
+}
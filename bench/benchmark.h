@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Times named benchmark bodies and writes one machine-readable record per benchmark. Each body processes itemCount
+// items and returns a checksum of its results, which is folded into a sink so the work cannot be optimised away.
+// Bodies that modify their input take a setup that restores it before every iteration, outside the timed region
+class BenchmarkRunner {
+public:
+	typedef std::function<std::uint64_t()> body_t;
+	typedef std::function<void()> setup_t;
+
+	enum OutputFormat {
+		Csv,
+		Json,
+	};
+
+	struct Options {
+		OutputFormat format = Csv;
+		std::chrono::nanoseconds minSampleTime = std::chrono::milliseconds(100);
+		int samples = 5;
+		std::string filter;
+	};
+
+	BenchmarkRunner(std::ostream& output, const Options& options);
+
+	bool isSelected(const std::string& name) const;
+	void run(const std::string& name, std::size_t itemCount, const body_t& body, const setup_t& setup = nullptr);
+
+	std::uint64_t getChecksum() const;
+private:
+	struct Result {
+		std::string name;
+		std::size_t itemCount;
+		std::size_t iterations;
+		double medianNs;
+		double minNs;
+	};
+
+	std::size_t calibrate(const body_t& body, const setup_t& setup);
+	std::chrono::nanoseconds runIterations(const body_t& body, const setup_t& setup, std::size_t iterations);
+	void writeHeader();
+	void writeResult(const Result& result);
+
+	std::ostream& mOutput;
+	Options mOptions;
+	bool mHasWrittenHeader = false;
+	std::uint64_t mChecksum = 0;
+};
@@ -0,0 +1,58 @@
+#include "generators.h"
+
+#include <random>
+
+namespace Generators {
+	static int uniform(std::mt19937_64& rng, int min, int max) {
+		return min + (int)(rng() % (std::uint64_t)(max - min + 1));
+	}
+
+	std::vector<Algebra::Polynomial> makePolynomials(std::size_t count, std::uint64_t seed) {
+		std::mt19937_64 rng(seed);
+		std::vector<Algebra::Polynomial> polynomials(count);
+		for (auto& polynomial : polynomials) {
+			int coeffs[Algebra::Limits::MAX_EXPONENT + 1]{};
+			int degree = uniform(rng, 0, Algebra::Limits::MAX_EXPONENT);
+			coeffs[0] = uniform(rng, -Algebra::Limits::MAX_CONSTANT, Algebra::Limits::MAX_CONSTANT);
+			for (int exp = 1; exp <= degree; exp++)
+				coeffs[exp] = uniform(rng, -Algebra::Limits::MAX_COEFFICIENT, Algebra::Limits::MAX_COEFFICIENT);
+			if (coeffs[degree] == 0)
+				coeffs[degree] = 1;
+			polynomial.setCoefficients(coeffs);
+		}
+		return polynomials;
+	}
+
+	Algebra::SequenceSet makeSequences(std::span<const Algebra::Polynomial> polynomials, std::size_t length, std::uint64_t seed) {
+		std::mt19937_64 rng(seed);
+		Algebra::SequenceSet sequences;
+		sequences.reserve(polynomials.size(), polynomials.size() * length);
+		for (const auto& polynomial : polynomials) {
+			int offset = uniform(rng, -10, 10), step = uniform(rng, 1, 3);
+			std::span<int> elements = sequences.resizeBack(length);
+			for (std::size_t i = 0; i < length; i++) {
+				long long x = offset + (long long)i * step, y = 0;
+				for (int exp = Algebra::Limits::MAX_EXPONENT; exp >= 0; exp--)
+					y = y * x + polynomial.getCoefficient(exp);
+				elements[i] = (int)y;
+			}
+		}
+		return sequences;
+	}
+
+	std::vector<std::string> makeExpressionLines(std::span<const Algebra::Polynomial> polynomials) {
+		std::vector<std::string> lines;
+		lines.reserve(polynomials.size());
+		for (const auto& polynomial : polynomials)
+			lines.push_back(polynomial.toString());
+		return lines;
+	}
+
+	std::vector<std::string> makeSequenceLines(const Algebra::SequenceSet& sequences) {
+		std::vector<std::string> lines;
+		lines.reserve(sequences.size());
+		for (std::size_t i = 0; i < sequences.size(); i++)
+			lines.push_back(sequences[i].toString());
+		return lines;
+	}
+}
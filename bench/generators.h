@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "polynomial.h"
+#include "sequence_set.h"
+
+// Synthetic benchmark data. Values come straight from std::mt19937_64, whose output the standard fixes, rather than
+// from the distributions, whose output it does not, so a seed produces the same data with every compiler
+namespace Generators {
+	// Polynomials of degree 0 to Limits::MAX_EXPONENT with coefficients inside the parser's limits
+	std::vector<Algebra::Polynomial> makePolynomials(std::size_t count, std::uint64_t seed);
+
+	// One sequence of `length` elements per polynomial, sampled at a random offset and step inside the derivation search
+	// range, so every sequence is derivable
+	Algebra::SequenceSet makeSequences(std::span<const Algebra::Polynomial> polynomials, std::size_t length, std::uint64_t seed);
+
+	std::vector<std::string> makeExpressionLines(std::span<const Algebra::Polynomial> polynomials);
+	std::vector<std::string> makeSequenceLines(const Algebra::SequenceSet& sequences);
+}
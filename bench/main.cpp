@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "batch.h"
+#include "benchmark.h"
+#include "derivation_cache.h"
+#include "file_handle.h"
+#include "generators.h"
+#include "polynomial.h"
+#include "polynomial_set.h"
+#include "sequence_set.h"
+#include "thread_pool.h"
+
+struct BenchOptions {
+	BenchmarkRunner::Options runner;
+	std::vector<std::size_t> sizes = { 1000, 10000, 100000 };
+	std::size_t length = 8;
+	std::uint64_t seed = 8501;
+};
+
+template<typename T>
+static bool parseNumber(std::string_view text, T& value) {
+	auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+	return error == std::errc() && end == text.data() + text.size();
+}
+
+static bool parseSizes(std::string_view text, std::vector<std::size_t>& sizes) {
+	sizes.clear();
+	while (!text.empty()) {
+		std::size_t end = std::min(text.find(','), text.size());
+		std::size_t size;
+		if (!parseNumber(text.substr(0, end), size) || size == 0)
+			return false;
+		sizes.push_back(size);
+		text.remove_prefix(std::min(end + 1, text.size()));
+	}
+	return !sizes.empty();
+}
+
+static bool parseArguments(int argc, char** argv, BenchOptions& options) {
+	for (int i = 1; i < argc; i++) {
+		std::string_view option = argv[i];
+		if (i + 1 == argc)
+			return false;
+		std::string_view value = argv[++i];
+		bool isValid;
+		if (option == "--format") {
+			isValid = value == "csv" || value == "json";
+			options.runner.format = (value == "json") ? BenchmarkRunner::Json : BenchmarkRunner::Csv;
+		} else if (option == "--sizes") {
+			isValid = parseSizes(value, options.sizes);
+		} else if (option == "--length") {
+			isValid = parseNumber(value, options.length) && options.length >= 3;
+		} else if (option == "--seed") {
+			isValid = parseNumber(value, options.seed);
+		} else if (option == "--samples") {
+			isValid = parseNumber(value, options.runner.samples) && options.runner.samples > 0;
+		} else if (option == "--min-time") {
+			long long milliseconds;
+			isValid = parseNumber(value, milliseconds) && milliseconds > 0;
+			options.runner.minSampleTime = std::chrono::milliseconds(isValid ? milliseconds : 0);
+		} else if (option == "--filter") {
+			isValid = true;
+			options.runner.filter = value;
+		} else {
+			isValid = false;
+		}
+		if (!isValid)
+			return false;
+	}
+	return true;
+}
+
+static void printUsage(const char* program) {
+	std::cerr << "Usage: " << program << " [options]\n"
+		<< "  --format csv|json   Output format, one record per benchmark (default csv)\n"
+		<< "  --sizes a,b,...     Sequence/polynomial counts to run every benchmark at (default 1000,10000,100000)\n"
+		<< "  --length n          Elements per generated sequence (default 8)\n"
+		<< "  --seed n            Seed for the synthetic data (default 8501)\n"
+		<< "  --samples n         Timed samples per benchmark (default 5)\n"
+		<< "  --min-time ms       Minimum duration of one sample (default 100)\n"
+		<< "  --filter text       Only run benchmarks whose name contains text\n";
+}
+
+static void runParseBenchmarks(BenchmarkRunner& runner, const std::string& suffix, const std::vector<Algebra::Polynomial>& polynomials, const Algebra::SequenceSet& sequences) {
+	std::vector<std::string> expressionLines = Generators::makeExpressionLines(polynomials);
+	std::vector<std::string> sequenceLines = Generators::makeSequenceLines(sequences);
+	runner.run("parse/expression" + suffix, expressionLines.size(), [&]() {
+		std::uint64_t parsed = 0;
+		Algebra::Polynomial polynomial;
+		for (const auto& line : expressionLines)
+			parsed += polynomial.parseFrom(line);
+		return parsed;
+	});
+	runner.run("parse/sequence" + suffix, sequenceLines.size(), [&]() {
+		Algebra::SequenceSet parsed;
+		for (const auto& line : sequenceLines)
+			parsed.parseBack(line);
+		return (std::uint64_t)parsed.getElementCount();
+	});
+}
+
+static void runAlgebraBenchmarks(BenchmarkRunner& runner, ThreadPool& pool, const std::string& suffix, const std::vector<Algebra::Polynomial>& polynomials, const Algebra::SequenceSet& sequences) {
+	runner.run("degree" + suffix, sequences.size(), [&]() {
+		std::uint64_t total = 0;
+		for (std::size_t i = 0; i < sequences.size(); i++)
+			total += sequences[i].getDegree();
+		return total;
+	});
+	const std::map<std::string, Algebra::SearchStrategy> strategies = {
+		{"exhaustive", Algebra::Exhaustive},
+		{"nearest", Algebra::NearestFirst},
+		{"analytic", Algebra::Analytic},
+	};
+	for (const auto& [strategyName, strategy] : strategies) {
+		runner.run("derive/serial/" + strategyName + suffix, sequences.size(), [&]() {
+			std::uint64_t derived = 0;
+			Algebra::Polynomial polynomial;
+			for (std::size_t i = 0; i < sequences.size(); i++)
+				derived += polynomial.deriveFrom(sequences[i], strategy);
+			return derived;
+		});
+	}
+	// Cold runs bypass the derivation cache and nodedup also skips grouping; warm runs repeat the same sequences, so after
+	// calibration every result is cached
+	Algebra::DerivationCache& cache = Algebra::DerivationCache::instance();
+	cache.setCapacity(0);
+	runner.run("derive/parallel/nodedup" + suffix, sequences.size(), [&]() {
+		return (std::uint64_t)Algebra::Batch::deriveAll(pool, sequences, Algebra::Analytic, false).derivedCount;
+	});
+	runner.run("derive/parallel/cold" + suffix, sequences.size(), [&]() {
+		return (std::uint64_t)Algebra::Batch::deriveAll(pool, sequences).derivedCount;
+	});
+	cache.setCapacity(std::max(sequences.size(), Algebra::DerivationCache::DEFAULT_CAPACITY));
+	runner.run("derive/parallel/warm" + suffix, sequences.size(), [&]() {
+		return (std::uint64_t)Algebra::Batch::deriveAll(pool, sequences).derivedCount;
+	});
+	cache.clear();
+
+	// apply works in place, so every iteration starts again from the generated sequences
+	Algebra::SequenceSet working = sequences;
+	const Algebra::Polynomial& polynomial = polynomials.front();
+	auto resetWorking = [&]() {
+		std::ranges::copy(sequences.getAllElements(), working.getAllElements().begin());
+	};
+	runner.run("apply/serial" + suffix, working.getElementCount(), [&]() {
+		std::span<int> elements = working.getAllElements();
+		polynomial.apply(elements);
+		return (std::uint64_t)(unsigned int)elements.back();
+	}, resetWorking);
+	runner.run("apply/parallel" + suffix, working.getElementCount(), [&]() {
+		Algebra::Batch::applyAll(pool, polynomial, working);
+		return (std::uint64_t)(unsigned int)working.getAllElements().back();
+	}, resetWorking);
+
+	Algebra::PolynomialSet polynomialSet(polynomials);
+	std::vector<int> results(polynomialSet.size());
+	runner.run("evaluate/columns" + suffix, polynomialSet.size(), [&]() {
+		polynomialSet.evaluateAt(7, results);
+		return (std::uint64_t)(unsigned int)results.back();
+	});
+}
+
+static void runFileBenchmarks(BenchmarkRunner& runner, ThreadPool& pool, const std::string& suffix, const Algebra::SequenceSet& sequences, const std::filesystem::path& directory) {
+	const std::map<std::string, FileHandler::SequenceFormat> formats = {
+		{"text", FileHandler::Text},
+		{"binary", FileHandler::Binary},
+		{"varint", FileHandler::DeltaVarint},
+	};
+	FileHandler fileHandler;
+	for (const auto& [formatName, format] : formats) {
+		std::string path = (directory / ("algebra_bench_" + formatName + "_" + suffix.substr(1))).string();
+		runner.run("file/write/" + formatName + suffix, sequences.size(), [&]() {
+			std::ofstream file(path, std::ios::binary);
+			return (std::uint64_t)fileHandler.writeSequenceStream(file, sequences, format);
+		});
+		{
+			std::ofstream file(path, std::ios::binary);
+			fileHandler.writeSequenceStream(file, sequences, format);
+		}
+		runner.run("file/read/" + formatName + suffix, sequences.size(), [&]() {
+			Algebra::SequenceSet read;
+			fileHandler.readSequenceFile(path, read, pool);
+			return (std::uint64_t)read.getElementCount();
+		});
+		std::error_code error;
+		std::filesystem::remove(path, error);
+	}
+}
+
+// Every benchmark runs once per requested size; names carry the size so results from different sizes stay distinct
+int main(int argc, char** argv) {
+	BenchOptions options;
+	if (!parseArguments(argc, argv, options)) {
+		printUsage(argv[0]);
+		return 1;
+	}
+	std::filesystem::path directory = std::filesystem::temp_directory_path();
+	ThreadPool pool;
+	BenchmarkRunner runner(std::cout, options.runner);
+	for (std::size_t size : options.sizes) {
+		std::string suffix = "/" + std::to_string(size);
+		std::vector<Algebra::Polynomial> polynomials = Generators::makePolynomials(size, options.seed);
+		Algebra::SequenceSet sequences = Generators::makeSequences(polynomials, options.length, options.seed + 1);
+		runParseBenchmarks(runner, suffix, polynomials, sequences);
+		runAlgebraBenchmarks(runner, pool, suffix, polynomials, sequences);
+		runFileBenchmarks(runner, pool, suffix, sequences, directory);
+	}
+	std::cerr << "Checksum " << runner.getChecksum() << "\n";
+	return 0;
+}
@@ -0,0 +1,202 @@
+#include "apply_kernel.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#include "polynomial.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ALGEBRA_KERNEL_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define KERNEL_TARGET(isa)
+#else
+#define KERNEL_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+namespace Algebra {
+	namespace Kernel {
+		// Every kernel is instantiated once per degree so the Horner loop has a compile-time trip count and unrolls fully
+		template<int Degree>
+		static void applyHornerScalar(const int* coeffs, int* elements, std::size_t count) {
+			for (std::size_t i = 0; i < count; i++) {
+				std::uint32_t x = (std::uint32_t)elements[i];
+				std::uint32_t y = (std::uint32_t)coeffs[Degree];
+				for (int exp = Degree - 1; exp >= 0; exp--)
+					y = y * x + (std::uint32_t)coeffs[exp];
+				elements[i] = (int)y;
+			}
+		}
+
+		template<int Degree>
+		static void evaluateColumnsScalar(const int* const* columns, int x, int* results, std::size_t count) {
+			for (std::size_t p = 0; p < count; p++) {
+				std::uint32_t y = (std::uint32_t)columns[Degree][p];
+				for (int exp = Degree - 1; exp >= 0; exp--)
+					y = y * (std::uint32_t)x + (std::uint32_t)columns[exp][p];
+				results[p] = (int)y;
+			}
+		}
+
+#ifdef ALGEBRA_KERNEL_X86
+		template<int Degree>
+		KERNEL_TARGET("avx2")
+		static void applyHornerAVX2(const int* coeffs, int* elements, std::size_t count) {
+			std::size_t i = 0;
+			for (; i + 8 <= count; i += 8) {
+				__m256i x = _mm256_loadu_si256((const __m256i*)(elements + i));
+				__m256i y = _mm256_set1_epi32(coeffs[Degree]);
+				for (int exp = Degree - 1; exp >= 0; exp--)
+					y = _mm256_add_epi32(_mm256_mullo_epi32(y, x), _mm256_set1_epi32(coeffs[exp]));
+				_mm256_storeu_si256((__m256i*)(elements + i), y);
+			}
+			applyHornerScalar<Degree>(coeffs, elements + i, count - i);
+		}
+
+		template<int Degree>
+		KERNEL_TARGET("avx512f")
+		static void applyHornerAVX512(const int* coeffs, int* elements, std::size_t count) {
+			std::size_t i = 0;
+			for (; i + 16 <= count; i += 16) {
+				__m512i x = _mm512_loadu_si512((const void*)(elements + i));
+				__m512i y = _mm512_set1_epi32(coeffs[Degree]);
+				for (int exp = Degree - 1; exp >= 0; exp--)
+					y = _mm512_add_epi32(_mm512_mullo_epi32(y, x), _mm512_set1_epi32(coeffs[exp]));
+				_mm512_storeu_si512((void*)(elements + i), y);
+			}
+			applyHornerAVX2<Degree>(coeffs, elements + i, count - i);
+		}
+
+		template<int Degree>
+		KERNEL_TARGET("avx2")
+		static void evaluateColumnsAVX2(const int* const* columns, int x, int* results, std::size_t count) {
+			__m256i xs = _mm256_set1_epi32(x);
+			std::size_t p = 0;
+			for (; p + 8 <= count; p += 8) {
+				__m256i y = _mm256_loadu_si256((const __m256i*)(columns[Degree] + p));
+				for (int exp = Degree - 1; exp >= 0; exp--)
+					y = _mm256_add_epi32(_mm256_mullo_epi32(y, xs), _mm256_loadu_si256((const __m256i*)(columns[exp] + p)));
+				_mm256_storeu_si256((__m256i*)(results + p), y);
+			}
+			const int* rest[Degree + 1];
+			for (int exp = 0; exp <= Degree; exp++)
+				rest[exp] = columns[exp] + p;
+			evaluateColumnsScalar<Degree>(rest, x, results + p, count - p);
+		}
+
+		template<int Degree>
+		KERNEL_TARGET("avx512f")
+		static void evaluateColumnsAVX512(const int* const* columns, int x, int* results, std::size_t count) {
+			__m512i xs = _mm512_set1_epi32(x);
+			std::size_t p = 0;
+			for (; p + 16 <= count; p += 16) {
+				__m512i y = _mm512_loadu_si512((const void*)(columns[Degree] + p));
+				for (int exp = Degree - 1; exp >= 0; exp--)
+					y = _mm512_add_epi32(_mm512_mullo_epi32(y, xs), _mm512_loadu_si512((const void*)(columns[exp] + p)));
+				_mm512_storeu_si512((void*)(results + p), y);
+			}
+			const int* rest[Degree + 1];
+			for (int exp = 0; exp <= Degree; exp++)
+				rest[exp] = columns[exp] + p;
+			evaluateColumnsAVX2<Degree>(rest, x, results + p, count - p);
+		}
+#endif
+
+		template<int Degree>
+		static void applyHornerFor(const int* coeffs, int* elements, std::size_t count, InstructionSet instructionSet) {
+			switch (instructionSet) {
+#ifdef ALGEBRA_KERNEL_X86
+				case AVX512: applyHornerAVX512<Degree>(coeffs, elements, count); break;
+				case AVX2: applyHornerAVX2<Degree>(coeffs, elements, count); break;
+#endif
+				default: applyHornerScalar<Degree>(coeffs, elements, count); break;
+			}
+		}
+
+		template<int Degree>
+		static void evaluateColumnsFor(const int* const* columns, int x, int* results, std::size_t count, InstructionSet instructionSet) {
+			switch (instructionSet) {
+#ifdef ALGEBRA_KERNEL_X86
+				case AVX512: evaluateColumnsAVX512<Degree>(columns, x, results, count); break;
+				case AVX2: evaluateColumnsAVX2<Degree>(columns, x, results, count); break;
+#endif
+				default: evaluateColumnsScalar<Degree>(columns, x, results, count); break;
+			}
+		}
+
+		typedef void (*apply_kernel_t)(const int*, int*, std::size_t, InstructionSet);
+		typedef void (*evaluate_kernel_t)(const int* const*, int, int*, std::size_t, InstructionSet);
+
+		template<std::size_t... Degrees>
+		static constexpr std::array<apply_kernel_t, sizeof...(Degrees)> makeApplyKernels(std::index_sequence<Degrees...>) {
+			return { &applyHornerFor<(int)Degrees>... };
+		}
+
+		template<std::size_t... Degrees>
+		static constexpr std::array<evaluate_kernel_t, sizeof...(Degrees)> makeEvaluateKernels(std::index_sequence<Degrees...>) {
+			return { &evaluateColumnsFor<(int)Degrees>... };
+		}
+
+		static constexpr auto APPLY_KERNELS = makeApplyKernels(std::make_index_sequence<Limits::MAX_SUPPORTED_EXPONENT + 1>());
+		static constexpr auto EVALUATE_KERNELS = makeEvaluateKernels(std::make_index_sequence<Limits::MAX_SUPPORTED_EXPONENT + 1>());
+
+#ifdef ALGEBRA_KERNEL_X86
+		static InstructionSet detectInstructionSet() {
+#if defined(_MSC_VER)
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7) return Scalar;
+			__cpuid(info, 1);
+			bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+			bool osSavesZmm = osSavesYmm && (_xgetbv(0) & 0xE0) == 0xE0;
+			__cpuidex(info, 7, 0);
+			if (osSavesZmm && (info[1] & (1 << 16))) return AVX512;
+			if (osSavesYmm && (info[1] & (1 << 5))) return AVX2;
+			return Scalar;
+#else
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx512f")) return AVX512;
+			if (__builtin_cpu_supports("avx2")) return AVX2;
+			return Scalar;
+#endif
+		}
+#endif
+
+		InstructionSet getInstructionSet() {
+#ifdef ALGEBRA_KERNEL_X86
+			static const InstructionSet instructionSet = detectInstructionSet();
+			return instructionSet;
+#else
+			return Scalar;
+#endif
+		}
+
+		const char* getInstructionSetName(InstructionSet instructionSet) {
+			switch (instructionSet) {
+				case AVX2: return "AVX2";
+				case AVX512: return "AVX-512";
+				default: return "Scalar";
+			}
+		}
+
+		void applyHorner(const int* coeffs, int degree, int* elements, std::size_t count) {
+			applyHorner(coeffs, degree, elements, count, getInstructionSet());
+		}
+
+		void applyHorner(const int* coeffs, int degree, int* elements, std::size_t count, InstructionSet instructionSet) {
+			APPLY_KERNELS[degree](coeffs, elements, count, std::min(instructionSet, getInstructionSet()));
+		}
+
+		void evaluateColumns(const int* const* columns, int degree, int x, int* results, std::size_t count) {
+			evaluateColumns(columns, degree, x, results, count, getInstructionSet());
+		}
+
+		void evaluateColumns(const int* const* columns, int degree, int x, int* results, std::size_t count, InstructionSet instructionSet) {
+			EVALUATE_KERNELS[degree](columns, x, results, count, std::min(instructionSet, getInstructionSet()));
+		}
+	}
+}
\ No newline at end of file
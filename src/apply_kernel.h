@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Algebra {
+	namespace Kernel {
+		enum InstructionSet {
+			Scalar,
+			AVX2,
+			AVX512,
+		};
+
+		InstructionSet getInstructionSet();
+		const char* getInstructionSetName(InstructionSet instructionSet);
+
+		// Replaces every element x with sum(coeffs[exp] * x^exp) for exp <= degree, evaluated in Horner form.
+		// Arithmetic wraps in two's complement, so results match a wrapping 64-bit evaluation truncated to int
+		void applyHorner(const int* coeffs, int degree, int* elements, std::size_t count);
+		void applyHorner(const int* coeffs, int degree, int* elements, std::size_t count, InstructionSet instructionSet);
+
+		// Evaluates count polynomials stored column-wise, where columns[exp][p] is polynomial p's x^exp coefficient, at the
+		// same x and writes polynomial p's value to results[p]. Wraps exactly like applyHorner
+		void evaluateColumns(const int* const* columns, int degree, int x, int* results, std::size_t count);
+		void evaluateColumns(const int* const* columns, int degree, int x, int* results, std::size_t count, InstructionSet instructionSet);
+	}
+}
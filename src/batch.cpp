@@ -0,0 +1,134 @@
+#include "batch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+
+#include "derivation_cache.h"
+
+namespace Algebra {
+	namespace Batch {
+		void applyAll(ThreadPool& pool, const Polynomial& polynomial, SequenceSet& sequences) {
+			std::span<int> elements = sequences.getAllElements();
+			std::size_t target = std::max(MIN_CHUNK_ELEMENTS, elements.size() / (pool.getWorkerCount() * CHUNKS_PER_WORKER) + 1);
+			std::size_t chunkCount = (elements.size() + target - 1) / target;
+			pool.parallelFor(chunkCount, [&](std::size_t c) {
+				std::size_t begin = c * target;
+				polynomial.apply(elements.subspan(begin, std::min(target, elements.size() - begin)));
+			});
+		}
+
+		// Sequences of two or fewer elements, or of too high a degree, all fail to derive and share the degree -1
+		struct NormalForm {
+			std::uint64_t hash;
+			int degree;
+			long long differences[Limits::MAX_EXPONENT + 1];
+		};
+
+		static NormalForm getNormalForm(SequenceView sequence) {
+			NormalForm form{ 0, -1, {} };
+			if (sequence.elements.size() > 2) {
+				int degree = sequence.getDegree(form.differences);
+				if (degree <= Limits::MAX_EXPONENT)
+					form.degree = degree;
+			}
+			std::uint64_t hash = 0x9E3779B97F4A7C15ull ^ (std::uint64_t)(form.degree + 1);
+			for (int k = 0; k <= form.degree; k++) {
+				hash = (hash ^ (std::uint64_t)form.differences[k]) * 0xC2B2AE3D27D4EB4Full;
+				hash ^= hash >> 31;
+			}
+			form.hash = hash;
+			return form;
+		}
+
+		static const std::size_t EMPTY_SLOT = SIZE_MAX;
+
+		static bool isSameForm(const NormalForm& a, const NormalForm& b) {
+			return a.degree == b.degree && std::equal(a.differences, a.differences + a.degree + 1, b.differences);
+		}
+
+		// Normal forms are computed on the pool, then grouped in one pass through an open-addressing table at least twice
+		// the size of the set. Slots keep the hash next to the group, so forms are only compared when the hashes agree
+		Groups groupForDerivation(ThreadPool& pool, const SequenceSet& sequences) {
+			std::vector<NormalForm> forms(sequences.size());
+			std::size_t target = sequences.size() / (pool.getWorkerCount() * CHUNKS_PER_WORKER) + 1;
+			pool.parallelFor((sequences.size() + target - 1) / target, [&](std::size_t c) {
+				for (std::size_t i = c * target; i < std::min(sequences.size(), (c + 1) * target); i++)
+					forms[i] = getNormalForm(sequences[i]);
+			});
+			Groups groups;
+			groups.groupOf.resize(sequences.size());
+			std::vector<std::pair<std::uint64_t, std::size_t>> slots(std::bit_ceil(2 * sequences.size() + 1), { 0, EMPTY_SLOT });
+			std::size_t mask = slots.size() - 1;
+			for (std::size_t i = 0; i < sequences.size(); i++) {
+				for (std::size_t slot = forms[i].hash & mask;; slot = (slot + 1) & mask) {
+					auto& [hash, group] = slots[slot];
+					if (group == EMPTY_SLOT) {
+						hash = forms[i].hash;
+						group = groups.groupOf[i] = groups.representatives.size();
+						groups.representatives.push_back(i);
+						break;
+					}
+					if (hash == forms[i].hash && isSameForm(forms[groups.representatives[group]], forms[i])) {
+						groups.groupOf[i] = group;
+						break;
+					}
+				}
+			}
+			return groups;
+		}
+
+		// Without deduplication every sequence is its own group
+		static Groups groupIndividually(std::size_t count) {
+			Groups groups;
+			groups.representatives.resize(count);
+			std::iota(groups.representatives.begin(), groups.representatives.end(), (std::size_t)0);
+			groups.groupOf = groups.representatives;
+			return groups;
+		}
+
+		DeriveResults deriveAll(ThreadPool& pool, const SequenceSet& sequences, SearchStrategy strategy, bool deduplicate) {
+			DeriveResults results;
+			results.polynomials.resize(sequences.size());
+			results.isDerived.resize(sequences.size(), 0);
+			results.candidateCounts.resize(sequences.size(), 0);
+			Groups groups = deduplicate ? groupForDerivation(pool, sequences) : groupIndividually(sequences.size());
+			DerivationCache& cache = DerivationCache::instance();
+			bool useCache = cache.getCapacity() > 0;
+			std::atomic<std::size_t> cacheHits = 0;
+			pool.parallelFor(groups.representatives.size(), [&](std::size_t g) {
+				std::size_t i = groups.representatives[g];
+				std::uint64_t fingerprint = 0;
+				if (useCache) {
+					bool isDerived;
+					fingerprint = DerivationCache::getFingerprint(sequences[i], strategy);
+					if (cache.find(fingerprint, sequences[i], strategy, results.polynomials[i], isDerived)) {
+						results.isDerived[i] = isDerived;
+						cacheHits.fetch_add(1, std::memory_order_relaxed);
+						return;
+					}
+				}
+				SearchStatistics statistics;
+				results.isDerived[i] = results.polynomials[i].deriveFrom(sequences[i], strategy, statistics);
+				results.candidateCounts[i] = statistics.candidatesExamined;
+				if (useCache)
+					cache.insert(fingerprint, sequences[i], strategy, results.polynomials[i], results.isDerived[i]);
+			});
+			for (std::size_t i = 0; i < sequences.size(); i++) {
+				std::size_t representative = groups.representatives[groups.groupOf[i]];
+				if (representative == i)
+					continue;
+				results.polynomials[i] = results.polynomials[representative];
+				results.isDerived[i] = results.isDerived[representative];
+			}
+			results.uniqueCount = groups.representatives.size();
+			results.cacheHits = cacheHits;
+			results.derivedCount = std::count(results.isDerived.begin(), results.isDerived.end(), 1);
+			results.candidateCount = std::accumulate(results.candidateCounts.begin(), results.candidateCounts.end(), (std::size_t)0);
+			return results;
+		}
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "polynomial.h"
+#include "sequence_set.h"
+#include "thread_pool.h"
+
+namespace Algebra {
+	namespace Batch {
+		// Applies the polynomial to every sequence on the pool. Elements are stored contiguously, so the element column
+		// is simply cut into equal chunks regardless of where sequences start and end
+		void applyAll(ThreadPool& pool, const Polynomial& polynomial, SequenceSet& sequences);
+
+		// Partition of a set into groups that share one result. representatives holds the first index of each group and
+		// groupOf the group of every sequence
+		struct Groups {
+			std::vector<std::size_t> representatives;
+			std::vector<std::size_t> groupOf;
+		};
+
+		// Groups sequences that derive to the same result. deriveFrom only reads a sequence's degree and leading
+		// differences, so identical sequences share a group, as does a sequence with any longer run of the same values
+		Groups groupForDerivation(ThreadPool& pool, const SequenceSet& sequences);
+
+		struct DeriveResults {
+			std::vector<Polynomial> polynomials;
+			std::vector<unsigned char> isDerived;
+			std::vector<std::size_t> candidateCounts;
+			std::size_t derivedCount = 0;
+			std::size_t candidateCount = 0;
+			std::size_t cacheHits = 0;
+			std::size_t uniqueCount = 0;
+		};
+
+		// Derives a polynomial for every sequence on the pool. With deduplicate set, sequences are grouped first and each
+		// group is searched once, so uniqueCount searches stand in for the whole set; grouping costs about as much as an
+		// analytic search, so it pays off once duplicates are common or searches are expensive. Results are indexed like
+		// the input; sequences that could not be derived keep an unloaded polynomial and a zero isDerived flag.
+		// candidateCounts holds the number of (step, offset) candidates each search examined, which is zero for
+		// duplicates and for results served by the DerivationCache
+		DeriveResults deriveAll(ThreadPool& pool, const SequenceSet& sequences, SearchStrategy strategy = Analytic, bool deduplicate = true);
+
+		const std::size_t MIN_CHUNK_ELEMENTS = 1 << 14;
+		const std::size_t CHUNKS_PER_WORKER = 4;
+	}
+}
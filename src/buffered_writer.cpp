@@ -0,0 +1,64 @@
+#include "buffered_writer.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+// Longest int in decimal: sign plus ten digits
+static const std::size_t MAX_INT_CHARS = 11;
+
+BufferedWriter::BufferedWriter(std::ostream& stream, std::size_t blockSize) :
+mStream(stream), mOwnedBlock(new char[std::max(blockSize, MAX_INT_CHARS)]), mBlock(mOwnedBlock.get()), mBlockSize(std::max(blockSize, MAX_INT_CHARS)) {
+
+}
+
+// A borrowed block smaller than the default is grown once; later writers reuse it as is
+BufferedWriter::BufferedWriter(std::ostream& stream, std::vector<char>& block) : mStream(stream), mOwnedBlock() {
+	if (block.size() < DEFAULT_BLOCK_SIZE)
+		block.resize(DEFAULT_BLOCK_SIZE);
+	mBlock = block.data();
+	mBlockSize = block.size();
+}
+
+BufferedWriter::~BufferedWriter() {
+	flush();
+}
+
+void BufferedWriter::write(const char* data, std::size_t size) {
+	if (size > mBlockSize - mUsed) {
+		flush();
+		if (size >= mBlockSize) {
+			mStream.write(data, size);
+			return;
+		}
+	}
+	std::memcpy(mBlock + mUsed, data, size);
+	mUsed += size;
+}
+
+void BufferedWriter::write(std::string_view text) {
+	write(text.data(), text.size());
+}
+
+void BufferedWriter::put(char c) {
+	if (mUsed == mBlockSize)
+		flush();
+	mBlock[mUsed++] = c;
+}
+
+void BufferedWriter::writeInt(int value) {
+	if (mBlockSize - mUsed < MAX_INT_CHARS)
+		flush();
+	mUsed = std::to_chars(mBlock + mUsed, mBlock + mBlockSize, value).ptr - mBlock;
+}
+
+bool BufferedWriter::flush() {
+	if (mUsed > 0)
+		mStream.write(mBlock, mUsed);
+	mUsed = 0;
+	return mStream.good();
+}
+
+bool BufferedWriter::good() const {
+	return mStream.good();
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+// Formats output into one reusable block and hands it to the stream whenever the block fills, so writing a whole set
+// never needs more than a block of extra memory. The block is either allocated (uninitialised) by the writer or
+// borrowed from the caller, which lets an owner that writes often keep one block across writers
+class BufferedWriter {
+public:
+	explicit BufferedWriter(std::ostream& stream, std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+	BufferedWriter(std::ostream& stream, std::vector<char>& block);
+	~BufferedWriter();
+	BufferedWriter(const BufferedWriter&) = delete;
+	BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+	void write(const char* data, std::size_t size);
+	void write(std::string_view text);
+	void put(char c);
+	void writeInt(int value);
+
+	// Lets `format` write at most maxSize characters straight into the block; it returns one past the last one written
+	template<typename Formatter>
+	void writeFormatted(std::size_t maxSize, const Formatter& format);
+
+	bool flush();
+	bool good() const;
+
+	static const std::size_t DEFAULT_BLOCK_SIZE = 1 << 20;
+private:
+	std::ostream& mStream;
+	std::unique_ptr<char[]> mOwnedBlock;
+	char* mBlock;
+	std::size_t mBlockSize;
+	std::size_t mUsed = 0;
+};
+
+template<typename Formatter>
+void BufferedWriter::writeFormatted(std::size_t maxSize, const Formatter& format) {
+	if (maxSize > mBlockSize) {
+		std::vector<char> scratch(maxSize);
+		write(scratch.data(), format(scratch.data()) - scratch.data());
+		return;
+	}
+	if (mBlockSize - mUsed < maxSize)
+		flush();
+	mUsed = format(mBlock + mUsed) - mBlock;
+}
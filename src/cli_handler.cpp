@@ -0,0 +1,194 @@
+#include "cli_handler.h"
+
+#include <charconv>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+CLIHandler::CLIHandler(int argc, char** argv) :
+mArguments(argv, argv + argc), mFileHandler(), mThreadPool() {
+
+}
+
+int CLIHandler::run() {
+	std::ios::sync_with_stdio(false);
+	if (!parseArguments()) {
+		printUsage();
+		return 1;
+	}
+	if (mCommand == "help") {
+		printUsage();
+		return 0;
+	}
+	if (!openOutput())
+		return 1;
+	bool success = (mCommand == "derive") ? derive() : (mCommand == "apply") ? apply() : convert();
+	mOutput->flush();
+	return success ? 0 : 1;
+}
+
+bool CLIHandler::parseArguments() {
+	if (mArguments.size() < 2)
+		return false;
+	mCommand = mArguments[1];
+	if (mCommand == "help" || mCommand == "-h" || mCommand == "--help") {
+		mCommand = "help";
+		return true;
+	}
+	if (mCommand != "derive" && mCommand != "apply" && mCommand != "convert")
+		return fail("Unknown command '" + mCommand + "'");
+
+	std::size_t i = 2;
+	if (mCommand == "apply") {
+		if (i == mArguments.size())
+			return fail("apply requires a polynomial");
+		mExpression = mArguments[i++];
+	}
+	for (; i < mArguments.size(); i++) {
+		const std::string& option = mArguments[i];
+		if (i + 1 == mArguments.size())
+			return fail("Missing value for '" + option + "'");
+		const std::string& value = mArguments[++i];
+		if (option == "-i" || option == "--input") {
+			mInputPath = value;
+		} else if (option == "-o" || option == "--output") {
+			mOutputPath = value;
+		} else if (option == "-f" || option == "--format") {
+			auto format = FORMATS.find(value);
+			if (format == FORMATS.end())
+				return fail("Unknown format '" + value + "'");
+			mFormat = format->second;
+		} else if (option == "-s" || option == "--strategy") {
+			auto strategy = STRATEGIES.find(value);
+			if (strategy == STRATEGIES.end())
+				return fail("Unknown search strategy '" + value + "'");
+			mStrategy = strategy->second;
+		} else if (option == "-d" || option == "--dedup") {
+			if (value != "on" && value != "off")
+				return fail("Expected on or off for '" + option + "'");
+			mDeduplicate = value == "on";
+		} else if (option == "-c" || option == "--cache") {
+			std::size_t capacity;
+			auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), capacity);
+			if (error != std::errc() || end != value.data() + value.size())
+				return fail("Invalid cache capacity '" + value + "'");
+			Algebra::DerivationCache::instance().setCapacity(capacity);
+		} else if (option == "-b" || option == "--batch") {
+			auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), mBatchSize);
+			if (error != std::errc() || end != value.data() + value.size() || mBatchSize == 0)
+				return fail("Invalid batch size '" + value + "'");
+		} else {
+			return fail("Unknown option '" + option + "'");
+		}
+	}
+	if (mCommand == "derive" && mFormat != FileHandler::Text)
+		return fail("derive writes expressions, which only have a text format");
+	return true;
+}
+
+bool CLIHandler::openOutput() {
+	bool isBinary = mFormat != FileHandler::Text;
+	if (mOutputPath == STANDARD_STREAM) {
+#ifdef _WIN32
+		if (isBinary)
+			_setmode(_fileno(stdout), _O_BINARY);
+#endif
+		return true;
+	}
+	mOutputFile.open(mOutputPath, isBinary ? std::ios::binary : std::ios::out);
+	if (!mOutputFile)
+		return fail("Could not open '" + mOutputPath + "' for writing");
+	mOutput = &mOutputFile;
+	return true;
+}
+
+// Output stays aligned with the input: sequences without a fitting polynomial produce an empty line, and each one is
+// reported on stderr by its line number so it cannot be mistaken for a dropped record. A fitted zero polynomial is
+// written as 0, so an empty line only ever means no fit
+bool CLIHandler::derive() {
+	std::size_t sequenceCount = 0, derivedCount = 0, uniqueCount = 0, candidateCount = 0, cacheHits = 0;
+	bool success = readSequences([&](Algebra::SequenceSet& batch) {
+		Algebra::Batch::DeriveResults results = Algebra::Batch::deriveAll(mThreadPool, batch, mStrategy, mDeduplicate);
+		for (std::size_t i = 0; i < batch.size(); i++)
+			if (!results.isDerived[i])
+				std::cerr << "Line " << sequenceCount + i + 1 << ": no polynomial fits\n";
+		sequenceCount += batch.size();
+		derivedCount += results.derivedCount;
+		uniqueCount += results.uniqueCount;
+		candidateCount += results.candidateCount;
+		cacheHits += results.cacheHits;
+		return mFileHandler.writeExpressionStream(*mOutput, results.polynomials);
+	});
+	if (!success)
+		return fail(mFileHandler.getError());
+	std::cerr << "Derived " << derivedCount << "/" << sequenceCount << " sequences: " << uniqueCount << " searched, "
+		<< sequenceCount - uniqueCount << " duplicates skipped, " << candidateCount << " candidates examined, " << cacheHits << " results cached\n";
+	return true;
+}
+
+bool CLIHandler::apply() {
+	Algebra::Polynomial polynomial;
+	if (!polynomial.parseFrom(mExpression))
+		return fail("Invalid polynomial '" + mExpression + "': " + polynomial.getError());
+	return transformSequences([&](Algebra::SequenceSet& batch) {
+		Algebra::Batch::applyAll(mThreadPool, polynomial, batch);
+		return true;
+	});
+}
+
+bool CLIHandler::convert() {
+	return transformSequences([](Algebra::SequenceSet&) { return true; });
+}
+
+// Files are mapped and read whole; stdin is streamed as text in batches of mBatchSize sequences
+bool CLIHandler::readSequences(const FileHandler::batch_callback_t& callback) {
+	if (mInputPath == STANDARD_STREAM)
+		return mFileHandler.readSequenceStream(std::cin, mBatchSize, callback);
+	Algebra::SequenceSet sequences;
+	return mFileHandler.readSequenceFile(mInputPath, sequences, mThreadPool) && callback(sequences);
+}
+
+// Text output is streamed batch by batch. Binary files lead with their counts and offsets, so binary output is
+// collected and written once the input is exhausted
+bool CLIHandler::transformSequences(const transform_t& transform) {
+	Algebra::SequenceSet collected;
+	bool success = readSequences([&](Algebra::SequenceSet& batch) {
+		if (!transform(batch))
+			return false;
+		if (mFormat == FileHandler::Text)
+			return mFileHandler.writeSequenceStream(*mOutput, batch);
+		collected.append(std::move(batch));
+		return true;
+	});
+	if (success && mFormat != FileHandler::Text)
+		success = mFileHandler.writeSequenceStream(*mOutput, collected, mFormat);
+	return success || fail(mFileHandler.getError());
+}
+
+bool CLIHandler::fail(const std::string& message) {
+	std::cerr << "Error: " << message << "\n";
+	return false;
+}
+
+void CLIHandler::printUsage() const {
+	std::string program = mArguments.empty() ? "CSC8501_Coursework" : mArguments[0];
+	std::cerr << "Usage: " << program << " <command> [options]\n"
+		<< "Commands:\n"
+		<< "  derive                 Derive a polynomial for every sequence, one expression per line\n"
+		<< "  apply <polynomial>     Apply the polynomial to every sequence\n"
+		<< "  convert                Rewrite the sequences in another format\n"
+		<< "  help                   Show this message\n"
+		<< "Options:\n"
+		<< "  -i, --input <path>     Text or binary sequence file to read, or - for stdin (default, text only)\n"
+		<< "  -o, --output <path>    File to write, or - for stdout (default)\n"
+		<< "  -f, --format <name>    Sequence output format: text (default), binary or varint\n"
+		<< "  -s, --strategy <name>  Derivation search: analytic (default), nearest or exhaustive\n"
+		<< "  -d, --dedup on|off     Search once per group of equivalent sequences (default on)\n"
+		<< "  -c, --cache <entries>  Derivation results to memoise, 0 to disable (default " << Algebra::DerivationCache::DEFAULT_CAPACITY << ")\n"
+		<< "  -b, --batch <count>    Sequences per batch when streaming stdin (default " << DEFAULT_BATCH_SIZE << ")\n"
+		<< "derive writes line N for sequence N. A zero polynomial is written as 0. A sequence no polynomial fits gets\n"
+		<< "an empty line, and stderr reports \"Line N: no polynomial fits\" for it\n"
+		<< "Without a command the interactive menus are started\n";
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "batch.h"
+#include "derivation_cache.h"
+#include "file_handle.h"
+#include "polynomial.h"
+#include "sequence_set.h"
+#include "thread_pool.h"
+
+// Non-interactive mode: runs one derive, apply or convert command over files or stdin/stdout and exits, so the
+// engine can be driven from scripts and pipelines without going through the menus
+class CLIHandler {
+public:
+	CLIHandler(int argc, char** argv);
+
+	int run();
+private:
+	typedef std::function<bool(Algebra::SequenceSet&)> transform_t;
+
+	bool parseArguments();
+	bool openOutput();
+
+	bool derive();
+	bool apply();
+	bool convert();
+
+	bool readSequences(const FileHandler::batch_callback_t& callback);
+	bool transformSequences(const transform_t& transform);
+
+	bool fail(const std::string& message);
+	void printUsage() const;
+
+	std::vector<std::string> mArguments;
+	std::string mCommand;
+	std::string mExpression;
+	std::string mInputPath = STANDARD_STREAM;
+	std::string mOutputPath = STANDARD_STREAM;
+	FileHandler::SequenceFormat mFormat = FileHandler::Text;
+	Algebra::SearchStrategy mStrategy = Algebra::Analytic;
+	bool mDeduplicate = true;
+	std::size_t mBatchSize = DEFAULT_BATCH_SIZE;
+
+	std::ofstream mOutputFile;
+	std::ostream* mOutput = &std::cout;
+
+	FileHandler mFileHandler;
+	ThreadPool mThreadPool;
+
+	static const std::size_t DEFAULT_BATCH_SIZE = 1 << 16;
+	inline static const std::string STANDARD_STREAM = "-";
+
+	inline static const std::map<std::string, FileHandler::SequenceFormat> FORMATS = {
+		{"text", FileHandler::Text},
+		{"binary", FileHandler::Binary},
+		{"varint", FileHandler::DeltaVarint},
+	};
+
+	inline static const std::map<std::string, Algebra::SearchStrategy> STRATEGIES = {
+		{"exhaustive", Algebra::Exhaustive},
+		{"nearest", Algebra::NearestFirst},
+		{"analytic", Algebra::Analytic},
+	};
+};
@@ -0,0 +1,96 @@
+#include "derivation_cache.h"
+
+#include <algorithm>
+
+namespace Algebra {
+	DerivationCache& DerivationCache::instance() {
+		static DerivationCache cache;
+		return cache;
+	}
+
+	DerivationCache::DerivationCache() : mMutex(), mEntries(), mIndex() {
+
+	}
+
+	// Multiply-xorshift over the elements, seeded with the length and strategy and finished with the murmur3 mixer
+	std::uint64_t DerivationCache::getFingerprint(SequenceView sequence, SearchStrategy strategy) {
+		std::uint64_t hash = 0x9E3779B97F4A7C15ull ^ ((std::uint64_t)sequence.elements.size() << 8) ^ (std::uint64_t)strategy;
+		for (int element : sequence.elements) {
+			hash = (hash ^ (std::uint32_t)element) * 0xC2B2AE3D27D4EB4Full;
+			hash ^= hash >> 31;
+		}
+		hash ^= hash >> 33;
+		hash *= 0xFF51AFD7ED558CCDull;
+		hash ^= hash >> 33;
+		hash *= 0xC4CEB9FE1A85EC53ull;
+		return hash ^ (hash >> 33);
+	}
+
+	bool DerivationCache::find(std::uint64_t fingerprint, SequenceView sequence, SearchStrategy strategy, Polynomial& polynomial, bool& isDerived) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		auto found = mIndex.find(fingerprint);
+		if (found == mIndex.end() || !matches(*found->second, sequence, strategy)) {
+			mMisses++;
+			return false;
+		}
+		mEntries.splice(mEntries.begin(), mEntries, found->second);
+		polynomial = found->second->polynomial;
+		isDerived = found->second->isDerived;
+		mHits++;
+		return true;
+	}
+
+	// A colliding fingerprint replaces the older entry, which keeps one entry per fingerprint in the index
+	void DerivationCache::insert(std::uint64_t fingerprint, SequenceView sequence, SearchStrategy strategy, const Polynomial& polynomial, bool isDerived) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mCapacity == 0)
+			return;
+		if (auto found = mIndex.find(fingerprint); found != mIndex.end()) {
+			Entry& entry = *found->second;
+			entry.elements.assign(sequence.elements.begin(), sequence.elements.end());
+			entry.strategy = strategy;
+			entry.polynomial = polynomial;
+			entry.isDerived = isDerived;
+			mEntries.splice(mEntries.begin(), mEntries, found->second);
+			return;
+		}
+		mEntries.push_front({ fingerprint, std::vector<int>(sequence.elements.begin(), sequence.elements.end()), strategy, polynomial, isDerived });
+		mIndex.emplace(fingerprint, mEntries.begin());
+		evictToCapacity();
+	}
+
+	std::size_t DerivationCache::getCapacity() {
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mCapacity;
+	}
+
+	void DerivationCache::setCapacity(std::size_t capacity) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mCapacity = capacity;
+		evictToCapacity();
+	}
+
+	DerivationCache::Statistics DerivationCache::getStatistics() {
+		std::lock_guard<std::mutex> lock(mMutex);
+		return { mHits, mMisses, mEvictions, mEntries.size(), mCapacity };
+	}
+
+	void DerivationCache::clear() {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mEntries.clear();
+		mIndex.clear();
+		mHits = mMisses = mEvictions = 0;
+	}
+
+	bool DerivationCache::matches(const Entry& entry, SequenceView sequence, SearchStrategy strategy) const {
+		return entry.strategy == strategy && std::equal(entry.elements.begin(), entry.elements.end(), sequence.elements.begin(), sequence.elements.end());
+	}
+
+	void DerivationCache::evictToCapacity() {
+		while (mEntries.size() > mCapacity) {
+			mIndex.erase(mEntries.back().fingerprint);
+			mEntries.pop_back();
+			mEvictions++;
+		}
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "polynomial.h"
+
+namespace Algebra {
+	// Process-wide LRU cache of derivation results keyed by a fingerprint of the sequence's elements and the search
+	// strategy. Sequences that could not be derived are cached too. Entries keep a copy of their elements, so a
+	// fingerprint collision is a miss rather than a wrong result
+	class DerivationCache {
+	public:
+		struct Statistics {
+			std::size_t hits;
+			std::size_t misses;
+			std::size_t evictions;
+			std::size_t entries;
+			std::size_t capacity;
+		};
+
+		static DerivationCache& instance();
+
+		static std::uint64_t getFingerprint(SequenceView sequence, SearchStrategy strategy);
+
+		bool find(std::uint64_t fingerprint, SequenceView sequence, SearchStrategy strategy, Polynomial& polynomial, bool& isDerived);
+		void insert(std::uint64_t fingerprint, SequenceView sequence, SearchStrategy strategy, const Polynomial& polynomial, bool isDerived);
+
+		std::size_t getCapacity();
+		void setCapacity(std::size_t capacity);
+
+		Statistics getStatistics();
+		void clear();
+
+		static constexpr std::size_t DEFAULT_CAPACITY = 1 << 16;
+	private:
+		DerivationCache();
+
+		struct Entry {
+			std::uint64_t fingerprint;
+			std::vector<int> elements;
+			SearchStrategy strategy;
+			Polynomial polynomial;
+			bool isDerived;
+		};
+
+		bool matches(const Entry& entry, SequenceView sequence, SearchStrategy strategy) const;
+		void evictToCapacity();
+
+		std::mutex mMutex;
+		std::list<Entry> mEntries;
+		std::unordered_map<std::uint64_t, std::list<Entry>::iterator> mIndex;
+		std::size_t mCapacity = DEFAULT_CAPACITY;
+		std::size_t mHits = 0;
+		std::size_t mMisses = 0;
+		std::size_t mEvictions = 0;
+	};
+}
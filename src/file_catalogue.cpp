@@ -0,0 +1,68 @@
+#include "file_catalogue.h"
+
+FileCatalogue::FileCatalogue(std::string directory, std::regex pattern, std::string preferredExtension) :
+	mDirectory(std::move(directory)), mPattern(std::move(pattern)), mPreferredExtension(std::move(preferredExtension)) {
+
+}
+
+bool FileCatalogue::contains(const std::string& name) {
+	refresh();
+	return mEntries.contains(name);
+}
+
+FileCatalogue::Entry* FileCatalogue::find(const std::string& name) {
+	refresh();
+	auto it = mEntries.find(name);
+	if (it == mEntries.end())
+		return nullptr;
+	refreshEntry(it->second);
+	return &it->second;
+}
+
+const std::vector<std::string>& FileCatalogue::getNames() {
+	refresh();
+	return mNames;
+}
+
+void FileCatalogue::invalidate() {
+	mIsValid = false;
+}
+
+// When several files share a name (e.g. text and binary sequences), the one with the preferred extension wins
+void FileCatalogue::refresh() {
+	std::error_code error;
+	std::filesystem::file_time_type modified = std::filesystem::last_write_time(mDirectory, error);
+	if (mIsValid && !error && modified == mDirectoryModified)
+		return;
+	mEntries.clear();
+	mNames.clear();
+	mIsValid = false;
+	if (error)
+		return;
+	for (const auto& file : std::filesystem::directory_iterator(mDirectory, error)) {
+		std::string filepath = file.path().string();
+		std::smatch m;
+		if (!file.is_regular_file(error) || !std::regex_match(filepath, m, mPattern))
+			continue;
+		auto [it, isNew] = mEntries.try_emplace(m[1].str());
+		if (isNew)
+			mNames.push_back(it->first);
+		else if (mPreferredExtension.empty() || file.path().extension() != mPreferredExtension)
+			continue;
+		it->second = { filepath, file.file_size(error), file.last_write_time(error), std::nullopt };
+	}
+	mDirectoryModified = modified;
+	mIsValid = true;
+}
+
+// Files rewritten in place keep the directory's modification time, so entries are re-stat'ed before their details are used
+void FileCatalogue::refreshEntry(Entry& entry) const {
+	std::error_code error;
+	std::uintmax_t size = std::filesystem::file_size(entry.path, error);
+	std::filesystem::file_time_type modified = std::filesystem::last_write_time(entry.path, error);
+	if (error || (size == entry.size && modified == entry.modified))
+		return;
+	entry.size = size;
+	entry.modified = modified;
+	entry.recordCount.reset();
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <regex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Cached listing of one resource directory, keyed by the name captured from each matching path. The directory is only
+// rescanned when its modification time changes or invalidate() is called, so lookups cost one stat and a hash probe
+class FileCatalogue {
+public:
+	struct Entry {
+		std::string path;
+		std::uintmax_t size;
+		std::filesystem::file_time_type modified;
+		std::optional<std::size_t> recordCount;
+	};
+
+	FileCatalogue(std::string directory, std::regex pattern, std::string preferredExtension = "");
+
+	bool contains(const std::string& name);
+	Entry* find(const std::string& name);
+	const std::vector<std::string>& getNames();
+
+	void invalidate();
+private:
+	void refresh();
+	void refreshEntry(Entry& entry) const;
+
+	std::string mDirectory;
+	std::regex mPattern;
+	std::string mPreferredExtension;
+
+	std::unordered_map<std::string, Entry> mEntries;
+	std::vector<std::string> mNames;
+	std::filesystem::file_time_type mDirectoryModified;
+	bool mIsValid = false;
+};
@@ -1,157 +1,609 @@
 #include "file_handle.h"
 
+#include <algorithm>
+#include <bit>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
 
 #define SEQUENCE_PATH(filename) SEQUENCE_DIRECTORY + filename + SEQUENCE_EXTENSION
+#define BINARY_SEQUENCE_PATH(filename) SEQUENCE_DIRECTORY + filename + BINARY_SEQUENCE_EXTENSION
 #define EXPRESSION_PATH(filename) EXPRESSION_DIRECTORY + filename + EXPRESSION_EXTENSION
 
-FileHandler::FileHandler() {
+static_assert(sizeof(std::int32_t) == sizeof(int), "Binary sequence files store elements as int32");
+
+static const std::uint16_t RAW_ENCODING = 0;
+static const std::uint16_t DELTA_VARINT_ENCODING = 1;
 
+template<typename T>
+static T toLittleEndian(T value) {
+	if constexpr (std::endian::native == std::endian::big) {
+		char* bytes = (char*)&value;
+		std::reverse(bytes, bytes + sizeof(T));
+	}
+	return value;
 }
 
-bool FileHandler::readSequences(std::string filename, std::vector<Algebra::Sequence>& sequences) {
-	if (!checkDirectory(SEQUENCE_DIRECTORY)) return false;
-	std::ifstream file;
-	file.open(SEQUENCE_PATH(filename));
-	if (!file.is_open()) {
-		mCurrentErrorState = FileNotFound;
-		return false;
+template<typename T>
+static T fromLittleEndian(T value) {
+	return toLittleEndian(value);
+}
+
+static std::uint32_t zigzagEncode(std::uint32_t delta) {
+	return (delta << 1) ^ (std::uint32_t)((std::int32_t)delta >> 31);
+}
+
+static std::uint32_t zigzagDecode(std::uint32_t value) {
+	return (value >> 1) ^ (0u - (value & 1));
+}
+
+static std::size_t getDeltaVarintSize(std::span<const int> elements) {
+	std::size_t size = 0;
+	std::uint32_t previous = 0;
+	for (int element : elements) {
+		std::uint32_t value = zigzagEncode((std::uint32_t)element - previous);
+		previous = (std::uint32_t)element;
+		do {
+			size++;
+		} while (value >>= 7);
+	}
+	return size;
+}
+
+static void encodeDeltaVarints(std::span<const int> elements, BufferedWriter& writer) {
+	std::uint32_t previous = 0;
+	for (int element : elements) {
+		std::uint32_t value = zigzagEncode((std::uint32_t)element - previous);
+		previous = (std::uint32_t)element;
+		for (; value >= 0x80; value >>= 7)
+			writer.put((char)(value | 0x80));
+		writer.put((char)value);
 	}
-	bool success = readSequences(file, sequences);
-	file.close();
-	return success;
 }
 
-bool FileHandler::writeSequences(std::string filename, const std::vector<Algebra::Sequence> sequences) {
+template<typename T>
+static void writeLittleEndian(BufferedWriter& writer, T value) {
+	value = toLittleEndian(value);
+	writer.write((const char*)&value, sizeof(T));
+}
+
+static bool decodeDeltaVarints(const char*& cursor, const char* end, std::span<int> elements) {
+	std::uint32_t previous = 0;
+	for (auto& element : elements) {
+		std::uint32_t value = 0;
+		for (int shift = 0;; shift += 7) {
+			if (cursor == end || shift > 28)
+				return false;
+			std::uint8_t byte = (std::uint8_t)*cursor++;
+			value |= (std::uint32_t)(byte & 0x7F) << shift;
+			if (!(byte & 0x80))
+				break;
+		}
+		previous += zigzagDecode(value);
+		element = (int)previous;
+	}
+	return true;
+}
+
+FileHandler::FileHandler() {
+
+}
+
+bool FileHandler::readSequences(std::string filename, Algebra::SequenceSet& sequences) {
+	return readSequences(filename, sequences, nullptr);
+}
+
+bool FileHandler::readSequences(std::string filename, Algebra::SequenceSet& sequences, ThreadPool& pool) {
+	return readSequences(filename, sequences, &pool);
+}
+
+bool FileHandler::readSequences(std::string filename, const sequence_callback_t& callback) {
+	MappedFile file;
+	if (!openSequenceFile(filename, file)) return false;
+	return isBinarySequenceFile(file) ? readBinarySequences(file, callback) : readTextSequences(file, callback);
+}
+
+bool FileHandler::writeSequences(std::string filename, const Algebra::SequenceSet& sequences, SequenceFormat format) {
 	if (!checkDirectory(SEQUENCE_DIRECTORY)) return false;
 	std::ofstream file;
-	file.open(SEQUENCE_PATH(filename));
-	writeSequences(file, sequences);
+	bool success;
+	if (format == Text) {
+		file.open(SEQUENCE_PATH(filename));
+		BufferedWriter writer(file, mWriteBlock);
+		success = writeSequences(writer, sequences);
+	} else {
+		file.open(BINARY_SEQUENCE_PATH(filename), std::ios::binary);
+		BufferedWriter writer(file, mWriteBlock);
+		success = writeBinarySequences(writer, { &sequences }, format);
+	}
 	file.close();
+	mSequenceCatalogue.invalidate();
+	if (!success) return false;
+	std::error_code error;
+	std::filesystem::remove((format == Text) ? BINARY_SEQUENCE_PATH(filename) : SEQUENCE_PATH(filename), error);
 	return true;
 }
 
-bool FileHandler::appendSequences(std::string filename, const std::vector<Algebra::Sequence> sequence) {
+bool FileHandler::appendSequences(std::string filename, const Algebra::SequenceSet& sequences) {
 	if (!checkDirectory(SEQUENCE_DIRECTORY)) return false;
+	MappedFile existing;
+	if (existing.open(BINARY_SEQUENCE_PATH(filename)) && isBinarySequenceFile(existing)) {
+		BinarySequenceHeader header;
+		std::memcpy(&header, existing.data(), sizeof(header));
+		Algebra::SequenceSet merged;
+		if (!readBinarySequences(existing, merged))
+			return false;
+		existing.close();
+		mSequenceCatalogue.invalidate();
+		// The merged file is written beside the original and renamed over it, so a failed write leaves the original intact
+		std::string path = BINARY_SEQUENCE_PATH(filename);
+		std::string temporaryPath = path + TEMPORARY_EXTENSION;
+		std::ofstream file;
+		file.open(temporaryPath, std::ios::binary);
+		BufferedWriter writer(file, mWriteBlock);
+		bool success = writeBinarySequences(writer, { &merged, &sequences }, (fromLittleEndian(header.encoding) == DELTA_VARINT_ENCODING) ? DeltaVarint : Binary);
+		file.close();
+		std::error_code error;
+		if (success && !file.fail()) {
+			std::filesystem::rename(temporaryPath, path, error);
+			if (!error)
+				return true;
+		}
+		mCurrentErrorState = WriteFailed;
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+	existing.close();
+	mSequenceCatalogue.invalidate();
 	std::ofstream file;
 	file.open(SEQUENCE_PATH(filename), std::ios::app);
-	writeSequences(file, sequence);
-	file.close();
-	return true;
+	BufferedWriter writer(file, mWriteBlock);
+	return writeSequences(writer, sequences);
 }
 
 bool FileHandler::readExpressions(std::string filename, std::vector<Algebra::Polynomial>& expressions) {
-	if (!checkDirectory(EXPRESSION_DIRECTORY)) return false;
-	std::ifstream file;
-	file.open(EXPRESSION_PATH(filename));
-	if (!file.is_open()) {
-		mCurrentErrorState = FileNotFound;
-		return false;
-	}
-	bool success = readExpressions(file, expressions);
-	file.close();
-	return success;
+	return readExpressions(filename, expressions, nullptr);
 }
 
-bool FileHandler::writeExpressions(std::string filename, const std::vector<Algebra::Polynomial> expressions) {
+bool FileHandler::readExpressions(std::string filename, std::vector<Algebra::Polynomial>& expressions, ThreadPool& pool) {
+	return readExpressions(filename, expressions, &pool);
+}
+
+bool FileHandler::writeExpressions(std::string filename, std::span<const Algebra::Polynomial> expressions) {
 	if (!checkDirectory(EXPRESSION_DIRECTORY)) return false;
+	mExpressionCatalogue.invalidate();
 	std::ofstream file;
 	file.open(EXPRESSION_PATH(filename));
-	writeExpressions(file, expressions);
-	file.close();
-	return true;
+	BufferedWriter writer(file, mWriteBlock);
+	return writeExpressions(writer, expressions);
 }
 
-bool FileHandler::appendExpressions(std::string filename, const std::vector<Algebra::Polynomial> expressions) {
+bool FileHandler::appendExpressions(std::string filename, std::span<const Algebra::Polynomial> expressions) {
 	if (!checkDirectory(EXPRESSION_DIRECTORY)) return false;
+	mExpressionCatalogue.invalidate();
 	std::ofstream file;
 	file.open(EXPRESSION_PATH(filename), std::ios::app);
-	writeExpressions(file, expressions);
-	file.close();
-	return true;
+	BufferedWriter writer(file, mWriteBlock);
+	return writeExpressions(writer, expressions);
+}
+
+bool FileHandler::readSequenceFile(std::string path, Algebra::SequenceSet& sequences, ThreadPool& pool) {
+	mErrorLine = 0;
+	MappedFile file;
+	if (!file.open(path)) {
+		mCurrentErrorState = FileNotFound;
+		return false;
+	}
+	return readSequences(file, sequences, &pool);
+}
+
+// Text is read a block at a time and complete lines are parsed into a batch, which is handed to the callback and
+// cleared whenever it reaches batchSize, so input of any length is processed in bounded memory
+bool FileHandler::readSequenceStream(std::istream& stream, std::size_t batchSize, const batch_callback_t& callback) {
+	mErrorLine = 0;
+	Algebra::SequenceSet batch;
+	std::size_t line = 0;
+	auto parseLine = [&](std::string_view text) {
+		line++;
+		if (!batch.parseBack(text)) {
+			mCurrentErrorState = MalformedSequence;
+			mErrorLine = line;
+			return false;
+		}
+		if (batch.size() < batchSize)
+			return true;
+		bool success = callback(batch);
+		batch.clear();
+		return success;
+	};
+
+	std::string pending;
+	std::vector<char> block(STREAM_BLOCK_BYTES);
+	while (stream.read(block.data(), block.size()) || stream.gcount() > 0) {
+		pending.append(block.data(), (std::size_t)stream.gcount());
+		std::size_t end = pending.rfind(SEQUENCE_DELIMITER);
+		if (end == std::string::npos)
+			continue;
+		if (!readLines(std::string_view(pending).substr(0, end + 1), parseLine))
+			return false;
+		pending.erase(0, end + 1);
+	}
+	if (stream.bad()) {
+		mCurrentErrorState = ReadFailed;
+		return false;
+	}
+	if (!readLines(pending, parseLine))
+		return false;
+	return batch.empty() || callback(batch);
+}
+
+bool FileHandler::writeSequenceStream(std::ostream& stream, const Algebra::SequenceSet& sequences, SequenceFormat format) {
+	BufferedWriter writer(stream, mWriteBlock);
+	return (format == Text) ? writeSequences(writer, sequences) : writeBinarySequences(writer, { &sequences }, format);
+}
+
+bool FileHandler::writeExpressionStream(std::ostream& stream, std::span<const Algebra::Polynomial> expressions) {
+	BufferedWriter writer(stream, mWriteBlock);
+	return writeExpressions(writer, expressions);
 }
 
 bool FileHandler::sequenceFileExists(std::string filename) {
-	std::vector<std::string> files;
-	return getSequenceFiles(files) && std::find(files.begin(), files.end(), filename) != files.end();
+	return mSequenceCatalogue.contains(filename);
 }
 
 bool FileHandler::expressionFileExists(std::string filename) {
-	std::vector<std::string> files;
-	return getExpressionFiles(files) && std::find(files.begin(), files.end(), filename) != files.end();
+	return mExpressionCatalogue.contains(filename);
 }
 
 bool FileHandler::getSequenceFiles(std::vector<std::string>& filenames) {
 	if (!checkDirectory(SEQUENCE_DIRECTORY)) return false;
-	for (const auto& entry : std::filesystem::directory_iterator(SEQUENCE_DIRECTORY)) {
-		std::string filepath = entry.path().string();
-		std::smatch m;
-		if (std::regex_search(filepath, m, SEQUENCE_FILE_REGEX))
-			filenames.push_back(m[1]);
-	}
+	const std::vector<std::string>& names = mSequenceCatalogue.getNames();
+	filenames.insert(filenames.end(), names.begin(), names.end());
 	return true;
 }
 
 bool FileHandler::getExpressionFiles(std::vector<std::string>& filenames) {
 	if (!checkDirectory(EXPRESSION_DIRECTORY)) return false;
-	for (const auto& entry : std::filesystem::directory_iterator(EXPRESSION_DIRECTORY)) {
-		std::string filepath = entry.path().string();
-		std::smatch m;
-		if (std::regex_search(filepath, m, EXPRESSION_FILE_REGEX))
-			filenames.push_back(m[1]);
+	const std::vector<std::string>& names = mExpressionCatalogue.getNames();
+	filenames.insert(filenames.end(), names.begin(), names.end());
+	return true;
+}
+
+bool FileHandler::getSequenceFileInfo(std::string filename, FileInfo& info) {
+	if (!checkDirectory(SEQUENCE_DIRECTORY)) return false;
+	return getFileInfo(mSequenceCatalogue, filename, info);
+}
+
+bool FileHandler::getExpressionFileInfo(std::string filename, FileInfo& info) {
+	if (!checkDirectory(EXPRESSION_DIRECTORY)) return false;
+	return getFileInfo(mExpressionCatalogue, filename, info);
+}
+
+bool FileHandler::getSequenceFileFormat(std::string filename, SequenceFormat& format) {
+	MappedFile file;
+	if (!openSequenceFile(filename, file)) return false;
+	format = Text;
+	if (isBinarySequenceFile(file)) {
+		BinarySequenceHeader header;
+		std::memcpy(&header, file.data(), sizeof(header));
+		format = (fromLittleEndian(header.encoding) == DELTA_VARINT_ENCODING) ? DeltaVarint : Binary;
 	}
 	return true;
 }
 
 std::string FileHandler::getError() {
-	return ERROR_MESSAGES.find(mCurrentErrorState)->second;
+	std::string message = ERROR_MESSAGES.find(mCurrentErrorState)->second;
+	if ((mCurrentErrorState == MalformedSequence || mCurrentErrorState == MalformedExpression) && mErrorLine > 0)
+		message += " (line " + std::to_string(mErrorLine) + ")";
+	return message;
 }
 
-bool FileHandler::readSequences(std::ifstream& stream, std::vector<Algebra::Sequence>& sequences) {
-	std::string line;
-	std::vector<Algebra::Sequence> newSequences;
-	while (std::getline(stream, line)) {
-		if (!newSequences.emplace_back().parseFrom(line)) {
-			mCurrentErrorState = MalformedExpression;
+bool FileHandler::readSequences(std::string filename, Algebra::SequenceSet& sequences, ThreadPool* pool) {
+	MappedFile file;
+	if (!openSequenceFile(filename, file)) return false;
+	return readSequences(file, sequences, pool);
+}
+
+bool FileHandler::readSequences(const MappedFile& file, Algebra::SequenceSet& sequences, ThreadPool* pool) {
+	if (isBinarySequenceFile(file))
+		return readBinarySequences(file, sequences);
+	return parseChunks(std::string_view(file.data(), file.size()), sequences, pool, MalformedSequence,
+		[](Algebra::SequenceSet& chunk, std::string_view line) { return chunk.parseBack(line); });
+}
+
+bool FileHandler::readExpressions(std::string filename, std::vector<Algebra::Polynomial>& expressions, ThreadPool* pool) {
+	if (!checkDirectory(EXPRESSION_DIRECTORY)) return false;
+	mErrorLine = 0;
+	MappedFile file;
+	if (!file.open(EXPRESSION_PATH(filename))) {
+		mCurrentErrorState = FileNotFound;
+		return false;
+	}
+	return parseChunks(std::string_view(file.data(), file.size()), expressions, pool, MalformedExpression,
+		[](std::vector<Algebra::Polynomial>& chunk, std::string_view line) { return chunk.emplace_back().parseFrom(line); });
+}
+
+static void appendChunk(std::vector<Algebra::Polynomial>& items, std::vector<Algebra::Polynomial>&& chunk) {
+	if (items.empty())
+		items = std::move(chunk);
+	else
+		items.insert(items.end(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
+}
+
+static void appendChunk(Algebra::SequenceSet& items, Algebra::SequenceSet&& chunk) {
+	items.append(std::move(chunk));
+}
+
+// Parses newline-aligned chunks of the file independently, then appends each chunk's results in file order
+template<typename Container, typename LineParser>
+bool FileHandler::parseChunks(std::string_view text, Container& items, ThreadPool* pool, ErrorState errorState, const LineParser& parseLine) {
+	std::vector<std::string_view> chunks = splitIntoChunks(text, (pool == nullptr) ? 1 : pool->getWorkerCount() * CHUNKS_PER_WORKER);
+	std::vector<Container> parsed(chunks.size());
+	std::vector<std::size_t> lineCounts(chunks.size(), 0);
+	std::vector<unsigned char> hasFailed(chunks.size(), 0);
+	auto parseChunk = [&](std::size_t c) {
+		hasFailed[c] = !readLines(chunks[c], [&](std::string_view line) {
+			lineCounts[c]++;
+			return parseLine(parsed[c], line);
+		});
+	};
+	if (pool == nullptr) {
+		for (std::size_t c = 0; c < chunks.size(); c++)
+			parseChunk(c);
+	} else {
+		pool->parallelFor(chunks.size(), parseChunk);
+	}
+
+	std::size_t line = 0;
+	for (std::size_t c = 0; c < chunks.size(); c++) {
+		line += lineCounts[c];
+		if (hasFailed[c]) {
+			mCurrentErrorState = errorState;
+			mErrorLine = line;
 			return false;
 		}
 	}
-	sequences.insert(sequences.end(), newSequences.begin(), newSequences.end());
+	for (auto& chunk : parsed)
+		appendChunk(items, std::move(chunk));
 	return true;
 }
 
-bool FileHandler::writeSequences(std::ofstream& stream, const std::vector<Algebra::Sequence> sequences) {
-	std::vector<std::string> setLines;
-	for (auto& set : sequences)
-		setLines.push_back(set.toString());
-	std::ostringstream oss;
-	if (!setLines.empty()) {
-		std::copy(setLines.begin(), setLines.end(), std::ostream_iterator<std::string>(oss, SEQUENCE_DELIMITER.c_str()));
+std::vector<std::string_view> FileHandler::splitIntoChunks(std::string_view text, std::size_t chunkCount) const {
+	chunkCount = std::max((std::size_t)1, std::min(chunkCount, text.size() / MIN_CHUNK_BYTES));
+	std::vector<std::string_view> chunks;
+	std::size_t begin = 0;
+	for (std::size_t c = 1; c <= chunkCount && begin < text.size(); c++) {
+		std::size_t end = (c == chunkCount) ? std::string_view::npos : text.find('\n', std::max(begin, text.size() / chunkCount * c));
+		end = (end == std::string_view::npos) ? text.size() : end + 1;
+		chunks.push_back(text.substr(begin, end - begin));
+		begin = end;
+	}
+	return chunks;
+}
+
+bool FileHandler::openSequenceFile(std::string filename, MappedFile& file) {
+	if (!checkDirectory(SEQUENCE_DIRECTORY)) return false;
+	mErrorLine = 0;
+	if (!file.open(BINARY_SEQUENCE_PATH(filename)) && !file.open(SEQUENCE_PATH(filename))) {
+		mCurrentErrorState = FileNotFound;
+		return false;
 	}
-	stream << oss.str();
 	return true;
 }
 
-bool FileHandler::readExpressions(std::ifstream& stream, std::vector<Algebra::Polynomial>& expressions) {
-	std::string line;
-	std::vector<Algebra::Polynomial> newExpressions;
-	while (std::getline(stream, line)) {
-		if (!newExpressions.emplace_back().parseFrom(line)) {
-			mCurrentErrorState = MalformedExpression;
+bool FileHandler::readLines(std::string_view text, const line_callback_t& callback) const {
+	const char* first = text.data();
+	const char* last = first + text.size();
+	while (first != last) {
+		const char* end = std::find(first, last, '\n');
+		std::string_view line(first, end - first);
+		if (!line.empty() && line.back() == '\r')
+			line.remove_suffix(1);
+		if (!callback(line))
 			return false;
-		}
+		first = (end == last) ? last : end + 1;
 	}
-	expressions.insert(expressions.end(), newExpressions.begin(), newExpressions.end());
 	return true;
 }
 
-bool FileHandler::writeExpressions(std::ofstream& stream, const std::vector<Algebra::Polynomial> expressions) {
-	for (const auto& expression : expressions)
-		stream << expression.toString() << EXPRESSION_DELIMITER;
+bool FileHandler::readTextSequences(const MappedFile& file, const sequence_callback_t& callback) {
+	Algebra::Sequence sequence;
+	std::size_t line = 0;
+	return readLines(std::string_view(file.data(), file.size()), [&](std::string_view text) {
+		line++;
+		if (!sequence.parseFrom(text)) {
+			mCurrentErrorState = MalformedSequence;
+			mErrorLine = line;
+			return false;
+		}
+		return callback(sequence);
+	});
+}
+
+bool FileHandler::writeSequences(BufferedWriter& writer, const Algebra::SequenceSet& sequences) {
+	for (std::size_t s = 0; s < sequences.size(); s++) {
+		std::span<const int> elements = sequences[s].elements;
+		for (std::size_t i = 0; i < elements.size(); i++) {
+			if (i > 0)
+				writer.put(ELEMENT_DELIMITER);
+			writer.writeInt(elements[i]);
+		}
+		writer.put(SEQUENCE_DELIMITER);
+	}
+	if (writer.flush())
+		return true;
+	mCurrentErrorState = WriteFailed;
+	return false;
+}
+
+bool FileHandler::isBinarySequenceFile(const MappedFile& file) const {
+	return file.size() >= sizeof(BinarySequenceHeader) && std::memcmp(file.data(), BINARY_SEQUENCE_MAGIC, sizeof(BINARY_SEQUENCE_MAGIC)) == 0;
+}
+
+bool FileHandler::readBinaryLayout(const MappedFile& file, BinarySequenceLayout& layout) {
+	BinarySequenceHeader header;
+	std::memcpy(&header, file.data(), sizeof(header));
+	layout.sequenceCount = fromLittleEndian(header.sequenceCount);
+	layout.elementCount = fromLittleEndian(header.elementCount);
+	layout.columnBytes = fromLittleEndian(header.columnBytes);
+	layout.encoding = fromLittleEndian(header.encoding);
+	std::size_t available = file.size() - sizeof(header);
+	mCurrentErrorState = MalformedSequence;
+	if (fromLittleEndian(header.version) != BINARY_SEQUENCE_VERSION || (layout.encoding != RAW_ENCODING && layout.encoding != DELTA_VARINT_ENCODING))
+		return false;
+	if (layout.sequenceCount >= available / sizeof(std::uint64_t) || layout.columnBytes != available - (layout.sequenceCount + 1) * sizeof(std::uint64_t))
+		return false;
+	// Every element takes at least one column byte, so the element count is bounded by the file size before anything is
+	// sized from it; the raw check divides rather than multiplies so a huge count cannot wrap around
+	if (layout.encoding == RAW_ENCODING && (layout.elementCount > layout.columnBytes / sizeof(std::int32_t) || layout.columnBytes != layout.elementCount * sizeof(std::int32_t)))
+		return false;
+	if (layout.encoding == DELTA_VARINT_ENCODING && layout.elementCount > layout.columnBytes)
+		return false;
+	layout.offsets = file.data() + sizeof(header);
+	layout.column = layout.offsets + (layout.sequenceCount + 1) * sizeof(std::uint64_t);
+	layout.cursor = layout.column;
+	if (readOffset(layout, 0) != 0 || readOffset(layout, layout.sequenceCount) != layout.elementCount)
+		return false;
+	mCurrentErrorState = NoError;
 	return true;
 }
 
+std::uint64_t FileHandler::readOffset(const BinarySequenceLayout& layout, std::uint64_t i) const {
+	std::uint64_t offset;
+	std::memcpy(&offset, layout.offsets + i * sizeof(offset), sizeof(offset));
+	return fromLittleEndian(offset);
+}
+
+// Sequences must be read in order: delta varint rows are only delimited by decoding the rows before them
+bool FileHandler::readBinaryRow(BinarySequenceLayout& layout, std::uint64_t i, std::span<int> elements) const {
+	std::uint64_t begin = readOffset(layout, i);
+	if (layout.encoding == RAW_ENCODING) {
+		if (!elements.empty())
+			std::memcpy(elements.data(), layout.column + begin * sizeof(std::int32_t), elements.size() * sizeof(std::int32_t));
+		if constexpr (std::endian::native != std::endian::little)
+			for (auto& element : elements)
+				element = fromLittleEndian(element);
+		return true;
+	}
+	return decodeDeltaVarints(layout.cursor, layout.column + layout.columnBytes, elements);
+}
+
+bool FileHandler::getBinaryRowSize(const BinarySequenceLayout& layout, std::uint64_t i, std::size_t& size) const {
+	std::uint64_t begin = readOffset(layout, i), end = readOffset(layout, i + 1);
+	if (end < begin || end > layout.elementCount)
+		return false;
+	size = end - begin;
+	// A delta varint row cannot hold more elements than there are column bytes left to decode
+	return layout.encoding == RAW_ENCODING || size <= (std::uint64_t)(layout.column + layout.columnBytes - layout.cursor);
+}
+
+bool FileHandler::readBinarySequences(const MappedFile& file, const sequence_callback_t& callback) {
+	BinarySequenceLayout layout;
+	if (!readBinaryLayout(file, layout))
+		return false;
+	for (std::uint64_t i = 0; i < layout.sequenceCount; i++) {
+		std::size_t size;
+		if (!getBinaryRowSize(layout, i, size)) {
+			mCurrentErrorState = MalformedSequence;
+			return false;
+		}
+		std::vector<int> elements(size);
+		if (!readBinaryRow(layout, i, elements)) {
+			mCurrentErrorState = MalformedSequence;
+			return false;
+		}
+		Algebra::Sequence sequence(std::move(elements));
+		if (!callback(sequence))
+			return false;
+	}
+	if (layout.encoding == RAW_ENCODING || layout.cursor == layout.column + layout.columnBytes)
+		return true;
+	mCurrentErrorState = MalformedSequence;
+	return false;
+}
+
+// The file's offsets and column already match the set's layout, so rows are copied straight into the set's column
+bool FileHandler::readBinarySequences(const MappedFile& file, Algebra::SequenceSet& sequences) {
+	BinarySequenceLayout layout;
+	if (!readBinaryLayout(file, layout))
+		return false;
+	std::size_t initialSize = sequences.size();
+	sequences.reserve(initialSize + layout.sequenceCount, sequences.getElementCount() + layout.elementCount);
+	for (std::uint64_t i = 0; i < layout.sequenceCount; i++) {
+		std::size_t size;
+		if (!getBinaryRowSize(layout, i, size) || !readBinaryRow(layout, i, sequences.resizeBack(size))) {
+			mCurrentErrorState = MalformedSequence;
+			sequences.truncate(initialSize);
+			return false;
+		}
+	}
+	if (layout.encoding == RAW_ENCODING || layout.cursor == layout.column + layout.columnBytes)
+		return true;
+	mCurrentErrorState = MalformedSequence;
+	sequences.truncate(initialSize);
+	return false;
+}
+
+// Sizes are gathered in a first pass so the header and offsets can be streamed ahead of the column without buffering it
+bool FileHandler::writeBinarySequences(BufferedWriter& writer, std::initializer_list<const Algebra::SequenceSet*> parts, SequenceFormat format) {
+	std::uint16_t encoding = (format == DeltaVarint) ? DELTA_VARINT_ENCODING : RAW_ENCODING;
+	std::uint64_t sequenceCount = 0, elementCount = 0, columnBytes = 0;
+	for (const auto* part : parts) {
+		sequenceCount += part->size();
+		elementCount += part->getElementCount();
+		if (encoding == RAW_ENCODING)
+			continue;
+		for (std::size_t i = 0; i < part->size(); i++)
+			columnBytes += getDeltaVarintSize((*part)[i].elements);
+	}
+	if (encoding == RAW_ENCODING)
+		columnBytes = elementCount * sizeof(std::int32_t);
+
+	BinarySequenceHeader header{};
+	std::memcpy(header.magic, BINARY_SEQUENCE_MAGIC, sizeof(header.magic));
+	header.version = toLittleEndian(BINARY_SEQUENCE_VERSION);
+	header.encoding = toLittleEndian(encoding);
+	header.sequenceCount = toLittleEndian(sequenceCount);
+	header.elementCount = toLittleEndian(elementCount);
+	header.columnBytes = toLittleEndian(columnBytes);
+	writer.write((const char*)&header, sizeof(header));
+	std::uint64_t offset = 0;
+	writeLittleEndian(writer, offset);
+	for (const auto* part : parts) {
+		for (std::size_t i = 0; i < part->size(); i++)
+			writeLittleEndian(writer, offset += (*part)[i].elements.size());
+	}
+
+	for (const auto* part : parts) {
+		std::span<const int> column = part->getAllElements();
+		if (encoding == DELTA_VARINT_ENCODING) {
+			for (std::size_t i = 0; i < part->size(); i++)
+				encodeDeltaVarints((*part)[i].elements, writer);
+		} else if constexpr (std::endian::native == std::endian::little) {
+			writer.write((const char*)column.data(), column.size() * sizeof(std::int32_t));
+		} else {
+			for (int element : column)
+				writeLittleEndian(writer, (std::int32_t)element);
+		}
+	}
+	if (writer.flush())
+		return true;
+	mCurrentErrorState = WriteFailed;
+	return false;
+}
+
+bool FileHandler::writeExpressions(BufferedWriter& writer, std::span<const Algebra::Polynomial> expressions) {
+	for (const auto& expression : expressions) {
+		writer.writeFormatted(Algebra::Polynomial::MAX_STRING_LENGTH, [&expression](char* first) { return expression.toChars(first); });
+		writer.put(EXPRESSION_DELIMITER);
+	}
+	if (writer.flush())
+		return true;
+	mCurrentErrorState = WriteFailed;
+	return false;
+}
+
 bool FileHandler::checkDirectory(std::string dir) {
 	if (!std::filesystem::exists(dir)) {
 		mCurrentErrorState = DirectoryMissing;
@@ -159,3 +611,29 @@ bool FileHandler::checkDirectory(std::string dir) {
 	}
 	return true;
 }
+
+bool FileHandler::getFileInfo(FileCatalogue& catalogue, std::string filename, FileInfo& info) {
+	FileCatalogue::Entry* entry = catalogue.find(filename);
+	if (entry == nullptr) {
+		mCurrentErrorState = FileNotFound;
+		return false;
+	}
+	if (!entry->recordCount)
+		entry->recordCount = countRecords(entry->path);
+	info = { entry->size, *entry->recordCount, entry->modified };
+	return true;
+}
+
+// Binary sequence files store their count in the header; text files hold one record per line
+std::size_t FileHandler::countRecords(const std::string& path) {
+	MappedFile file;
+	if (!file.open(path) || file.size() == 0)
+		return 0;
+	if (isBinarySequenceFile(file)) {
+		BinarySequenceHeader header;
+		std::memcpy(&header, file.data(), sizeof(header));
+		return (std::size_t)fromLittleEndian(header.sequenceCount);
+	}
+	std::size_t lines = std::count(file.data(), file.data() + file.size(), '\n');
+	return (file.data()[file.size() - 1] == '\n') ? lines : lines + 1;
+}
@@ -1,24 +1,59 @@
 #pragma once
 
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <initializer_list>
 #include <iostream>
 #include <map>
 #include <regex>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "buffered_writer.h"
+#include "file_catalogue.h"
+#include "mapped_file.h"
 #include "polynomial.h"
+#include "sequence_set.h"
+#include "thread_pool.h"
 
 class FileHandler {
 public:
+	typedef std::function<bool(Algebra::Sequence&)> sequence_callback_t;
+	typedef std::function<bool(Algebra::SequenceSet&)> batch_callback_t;
+
+	enum SequenceFormat {
+		Text,
+		Binary,
+		DeltaVarint,
+	};
+
+	struct FileInfo {
+		std::uintmax_t size;
+		std::size_t recordCount;
+		std::filesystem::file_time_type modified;
+	};
+
 	FileHandler();
 
-	bool readSequences(std::string filename, std::vector<Algebra::Sequence>& sequences);
-	bool writeSequences(std::string filename, const std::vector<Algebra::Sequence> sequences);
-	bool appendSequences(std::string filename, const std::vector<Algebra::Sequence> sequences);
+	bool readSequences(std::string filename, Algebra::SequenceSet& sequences);
+	bool readSequences(std::string filename, Algebra::SequenceSet& sequences, ThreadPool& pool);
+	bool readSequences(std::string filename, const sequence_callback_t& callback);
+	bool writeSequences(std::string filename, const Algebra::SequenceSet& sequences, SequenceFormat format = Text);
+	bool appendSequences(std::string filename, const Algebra::SequenceSet& sequences);
 
 	bool readExpressions(std::string filename, std::vector<Algebra::Polynomial>& expressions);
-	bool writeExpressions(std::string filename, const std::vector<Algebra::Polynomial> expressions);
-	bool appendExpressions(std::string filename, const std::vector<Algebra::Polynomial> expressions);
+	bool readExpressions(std::string filename, std::vector<Algebra::Polynomial>& expressions, ThreadPool& pool);
+	bool writeExpressions(std::string filename, std::span<const Algebra::Polynomial> expressions);
+	bool appendExpressions(std::string filename, std::span<const Algebra::Polynomial> expressions);
+
+	// Path and stream variants for the command line mode, which works outside the resource directories
+	bool readSequenceFile(std::string path, Algebra::SequenceSet& sequences, ThreadPool& pool);
+	bool readSequenceStream(std::istream& stream, std::size_t batchSize, const batch_callback_t& callback);
+	bool writeSequenceStream(std::ostream& stream, const Algebra::SequenceSet& sequences, SequenceFormat format = Text);
+	bool writeExpressionStream(std::ostream& stream, std::span<const Algebra::Polynomial> expressions);
 
 	bool sequenceFileExists(std::string filename);
 	bool expressionFileExists(std::string filename);
@@ -26,27 +61,79 @@ public:
 	bool getSequenceFiles(std::vector<std::string>& filenames);
 	bool getExpressionFiles(std::vector<std::string>& filenames);
 
+	bool getSequenceFileInfo(std::string filename, FileInfo& info);
+	bool getExpressionFileInfo(std::string filename, FileInfo& info);
+	bool getSequenceFileFormat(std::string filename, SequenceFormat& format);
+
 	std::string getError();
 private:
-	bool readSequences(std::ifstream& stream, std::vector<Algebra::Sequence>& sequences);
-	bool writeSequences(std::ofstream& stream, const std::vector<Algebra::Sequence> sequences);
+	typedef std::function<bool(std::string_view)> line_callback_t;
+
+	// Binary layout: header, sequenceCount + 1 element offsets, then the element column as little-endian int32s or,
+	// for DeltaVarint, zigzag varints of the difference from the previous element in the same sequence
+	struct BinarySequenceHeader {
+		char magic[4];
+		std::uint16_t version;
+		std::uint16_t encoding;
+		std::uint64_t sequenceCount;
+		std::uint64_t elementCount;
+		std::uint64_t columnBytes;
+	};
+
+	struct BinarySequenceLayout {
+		std::uint64_t sequenceCount;
+		std::uint64_t elementCount;
+		std::uint64_t columnBytes;
+		std::uint16_t encoding;
+		const char* offsets;
+		const char* column;
+		const char* cursor;
+	};
+
+	bool openSequenceFile(std::string filename, MappedFile& file);
+	bool readLines(std::string_view text, const line_callback_t& callback) const;
+	bool readTextSequences(const MappedFile& file, const sequence_callback_t& callback);
+	bool writeSequences(BufferedWriter& writer, const Algebra::SequenceSet& sequences);
+
+	bool isBinarySequenceFile(const MappedFile& file) const;
+	bool readBinaryLayout(const MappedFile& file, BinarySequenceLayout& layout);
+	std::uint64_t readOffset(const BinarySequenceLayout& layout, std::uint64_t i) const;
+	bool getBinaryRowSize(const BinarySequenceLayout& layout, std::uint64_t i, std::size_t& size) const;
+	bool readBinaryRow(BinarySequenceLayout& layout, std::uint64_t i, std::span<int> elements) const;
+	bool readBinarySequences(const MappedFile& file, const sequence_callback_t& callback);
+	bool readBinarySequences(const MappedFile& file, Algebra::SequenceSet& sequences);
+	bool writeBinarySequences(BufferedWriter& writer, std::initializer_list<const Algebra::SequenceSet*> parts, SequenceFormat format);
 
-	bool readExpressions(std::ifstream& stream, std::vector<Algebra::Polynomial>& expressions);
-	bool writeExpressions(std::ofstream& stream, const std::vector<Algebra::Polynomial> expressions);
+	bool writeExpressions(BufferedWriter& writer, std::span<const Algebra::Polynomial> expressions);
 
 	bool checkDirectory(std::string dir);
+	bool getFileInfo(FileCatalogue& catalogue, std::string filename, FileInfo& info);
+	std::size_t countRecords(const std::string& path);
 
 	const std::string SEQUENCE_EXTENSION = ".sequence";
+	const std::string BINARY_SEQUENCE_EXTENSION = ".bsequence";
 	const std::string EXPRESSION_EXTENSION = ".expression";
+	const std::string TEMPORARY_EXTENSION = ".tmp";
 
 	const std::string SEQUENCE_DIRECTORY = "resources/sequences/";
 	const std::string EXPRESSION_DIRECTORY = "resources/expressions/";
 
-	const std::regex SEQUENCE_FILE_REGEX = std::regex(".*\\/([a-zA-Z]+)\\.sequence");
+	const std::regex SEQUENCE_FILE_REGEX = std::regex(".*\\/([a-zA-Z]+)\\.b?sequence");
 	const std::regex EXPRESSION_FILE_REGEX = std::regex(".*\\/([a-zA-Z]+)\\.expression");
 
-	const std::string SEQUENCE_DELIMITER = "\n";
-	const std::string EXPRESSION_DELIMITER = "\n";
+	FileCatalogue mSequenceCatalogue = FileCatalogue(SEQUENCE_DIRECTORY, SEQUENCE_FILE_REGEX, BINARY_SEQUENCE_EXTENSION);
+	FileCatalogue mExpressionCatalogue = FileCatalogue(EXPRESSION_DIRECTORY, EXPRESSION_FILE_REGEX);
+
+	const std::size_t MIN_CHUNK_BYTES = 1 << 20;
+	const std::size_t CHUNKS_PER_WORKER = 4;
+	const std::size_t STREAM_BLOCK_BYTES = 1 << 16;
+
+	const char SEQUENCE_DELIMITER = '\n';
+	const char ELEMENT_DELIMITER = ',';
+	const char EXPRESSION_DELIMITER = '\n';
+
+	const char BINARY_SEQUENCE_MAGIC[4] = { 'S', 'E', 'Q', 'B' };
+	const std::uint16_t BINARY_SEQUENCE_VERSION = 1;
 
 	enum ErrorState {
 		NoError,
@@ -54,8 +141,22 @@ private:
 		MalformedExpression,
 		MalformedSequence,
 		DirectoryMissing,
+		WriteFailed,
+		ReadFailed,
 	};
 	ErrorState mCurrentErrorState = NoError;
+	std::size_t mErrorLine = 0;
+
+	// Output block lent to every BufferedWriter, so repeated writes do not each allocate and clear a fresh block
+	std::vector<char> mWriteBlock;
+
+	bool readSequences(std::string filename, Algebra::SequenceSet& sequences, ThreadPool* pool);
+	bool readSequences(const MappedFile& file, Algebra::SequenceSet& sequences, ThreadPool* pool);
+	bool readExpressions(std::string filename, std::vector<Algebra::Polynomial>& expressions, ThreadPool* pool);
+
+	template<typename Container, typename LineParser>
+	bool parseChunks(std::string_view text, Container& items, ThreadPool* pool, ErrorState errorState, const LineParser& parseLine);
+	std::vector<std::string_view> splitIntoChunks(std::string_view text, std::size_t chunkCount) const;
 
 	const std::map<ErrorState, std::string> ERROR_MESSAGES = {
 		{NoError, ""},
@@ -63,5 +164,7 @@ private:
 		{MalformedExpression, "File contains malformed expression"},
 		{MalformedSequence, "File contains malformed sequence"},
 		{DirectoryMissing, "Missing resource directory"},
+		{WriteFailed, "Failed to write file"},
+		{ReadFailed, "Failed to read input"},
 	};
 };
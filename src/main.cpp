@@ -1,6 +1,9 @@
+#include "cli_handler.h"
 #include "ui_handler.h"
 
-int main() {
+int main(int argc, char** argv) {
+	if (argc > 1)
+		return CLIHandler(argc, argv).run();
 	UIHandler uiHandler;
 	uiHandler.mainloop();
 	return 0;
@@ -0,0 +1,94 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() {
+
+}
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+bool MappedFile::open(const std::string& path) {
+	close();
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size)) {
+		CloseHandle(file);
+		return false;
+	}
+	mFileHandle = file;
+	mSize = (std::size_t)size.QuadPart;
+	if (mSize > 0) {
+		mMappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mMappingHandle == nullptr || (mData = (const char*)MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, 0)) == nullptr) {
+			close();
+			return false;
+		}
+	}
+#else
+	int file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+	struct stat status;
+	if (fstat(file, &status) != 0) {
+		::close(file);
+		return false;
+	}
+	mSize = (std::size_t)status.st_size;
+	if (mSize > 0) {
+		void* mapping = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, file, 0);
+		if (mapping == MAP_FAILED) {
+			::close(file);
+			mSize = 0;
+			return false;
+		}
+		madvise(mapping, mSize, MADV_SEQUENTIAL);
+		mData = (const char*)mapping;
+	}
+	::close(file);
+#endif
+	return mIsOpen = true;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+	if (mData != nullptr)
+		UnmapViewOfFile(mData);
+	if (mMappingHandle != nullptr)
+		CloseHandle(mMappingHandle);
+	if (mFileHandle != nullptr)
+		CloseHandle(mFileHandle);
+	mMappingHandle = mFileHandle = nullptr;
+#else
+	if (mData != nullptr)
+		munmap((void*)mData, mSize);
+#endif
+	mData = nullptr;
+	mSize = 0;
+	mIsOpen = false;
+}
+
+const char* MappedFile::data() const {
+	return mData;
+}
+
+std::size_t MappedFile::size() const {
+	return mSize;
+}
+
+bool MappedFile::isOpen() const {
+	return mIsOpen;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file. Empty files open successfully with a null data pointer
+class MappedFile {
+public:
+	MappedFile();
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool open(const std::string& path);
+	void close();
+
+	const char* data() const;
+	std::size_t size() const;
+	bool isOpen() const;
+private:
+	const char* mData = nullptr;
+	std::size_t mSize = 0;
+	bool mIsOpen = false;
+#ifdef _WIN32
+	void* mFileHandle = nullptr;
+	void* mMappingHandle = nullptr;
+#endif
+};
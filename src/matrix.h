@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+namespace Algebra {
+	// LU decomposition stored in place in a row-major buffer. Floating point scalars use partial pivoting,
+	// exact scalars take the first non-zero pivot so that the multipliers stay small
+	template<typename T>
+	struct Matrix {
+		Matrix(int n_) : n(n_), matrix(n * n, T(0)), permutation(n) {
+
+		}
+
+		T& operator()(int row, int col) {
+			return matrix[row * n + col];
+		}
+
+		const T& operator()(int row, int col) const {
+			return matrix[row * n + col];
+		}
+
+		bool decompose() {
+			using std::abs;
+			std::iota(permutation.begin(), permutation.end(), 0);
+			permutationSign = 1;
+			for (int k = 0; k < n; k++) {
+				int pivot = k;
+				for (int row = k + 1; row < n; row++) {
+					if constexpr (std::is_floating_point_v<T>) {
+						if (abs((*this)(row, k)) > abs((*this)(pivot, k)))
+							pivot = row;
+					} else if ((*this)(pivot, k) == T(0)) {
+						pivot = row;
+					}
+				}
+				if ((*this)(pivot, k) == T(0))
+					return isDecomposed = false;
+				if (pivot != k) {
+					std::swap_ranges(matrix.begin() + pivot * n, matrix.begin() + (pivot + 1) * n, matrix.begin() + k * n);
+					std::swap(permutation[pivot], permutation[k]);
+					permutationSign = -permutationSign;
+				}
+				for (int row = k + 1; row < n; row++) {
+					if ((*this)(row, k) == T(0)) continue;
+					T factor = ((*this)(row, k) /= (*this)(k, k));
+					for (int col = k + 1; col < n; col++)
+						(*this)(row, col) -= factor * (*this)(k, col);
+				}
+			}
+			return isDecomposed = true;
+		}
+
+		bool solve(std::vector<T>& vec) const {
+			if (!isDecomposed || vec.size() != static_cast<std::size_t>(n)) return false;
+			std::vector<T> out(n);
+			for (int row = 0; row < n; row++) {
+				out[row] = vec[permutation[row]];
+				for (int col = 0; col < row; col++)
+					out[row] -= (*this)(row, col) * out[col];
+			}
+			for (int row = n - 1; row >= 0; row--) {
+				for (int col = row + 1; col < n; col++)
+					out[row] -= (*this)(row, col) * out[col];
+				out[row] /= (*this)(row, row);
+			}
+			vec.swap(out);
+			return true;
+		}
+
+		bool getInverse(Matrix& inverse) const {
+			if (!isDecomposed) return false;
+			inverse = Matrix(n);
+			std::vector<T> column(n);
+			for (int col = 0; col < n; col++) {
+				std::fill(column.begin(), column.end(), T(0));
+				column[col] = T(1);
+				solve(column);
+				for (int row = 0; row < n; row++)
+					inverse(row, col) = column[row];
+			}
+			return true;
+		}
+
+		std::vector<T> operator*(const std::vector<T>& vec) const {
+			std::vector<T> out(n, T(0));
+			for (int row = 0; row < n; row++)
+				for (int col = 0; col < n; col++)
+					out[row] += (*this)(row, col) * vec[col];
+			return out;
+		}
+
+		T getDeterminant() const {
+			if (!isDecomposed) return T(0);
+			T det = T(permutationSign);
+			for (int i = 0; i < n; i++)
+				det *= (*this)(i, i);
+			return det;
+		}
+
+		int n;
+		std::vector<T> matrix;
+		std::vector<int> permutation;
+		int permutationSign = 1;
+		bool isDecomposed = false;
+	};
+}
@@ -1,100 +1,76 @@
 #include "polynomial.h"
 
+#include <charconv>
+#include <climits>
+#include <cmath>
 #include <numeric>
 #include <ranges>
 #include <sstream>
 
+#include "apply_kernel.h"
+#include "vandermonde_cache.h"
+
 namespace Algebra {
 
-	// Matrix operations based on: https://www.geeksforgeeks.org/adjoint-inverse-matrix/
-	Matrix::Matrix(int n_) : n(n_), matrix(n, std::vector<float>(n, 0.0f)) {
-		
+	// Overwrites values[i] with values[i + 1] - values[i]. Each store only clobbers a value the loop has already read, so the
+	// loop vectorizes; the OR of all differences tells whether the input row was constant
+	static bool differenceInPlace(long long* values, std::size_t count) {
+		long long nonzero = 0;
+		for (std::size_t i = 0; i + 1 < count; i++) {
+			values[i] = values[i + 1] - values[i];
+			nonzero |= values[i];
+		}
+		return nonzero != 0;
 	}
 
-	std::vector<float> Matrix::operator*(std::vector<float> vec) {
-		std::vector<float> out(vec.size(), 0);
-		for (int row = 0; row < n; row++)
-			for (int col = 0; col < n; col++)
-				out[row] += vec[col] * matrix[row][col];
-		return out;
+	SequenceView::SequenceView(std::span<const int> elements_) : elements(elements_) {
+
 	}
 
-	int Matrix::getDeterminant() {
-		if (n == 1)
-			return matrix[0][0];
-		int det = 0;
-		int sign = -1;
-		for (int f = 0; f < n; f++)
-			det += (sign *= -1) * matrix[0][f] * getCofactor(0, f).getDeterminant();
-		return det;
+	SequenceView::SequenceView(const Sequence& sequence) : elements(sequence.elements) {
+
 	}
 
-	Matrix Matrix::getCofactor(int p, int q) {
-		Matrix cofactor(n - 1);
-		for (int i = 0, j = 0, row = 0; row < n; row++, j = 0) {
-			for (int col = 0; col < n; col++) {
-				if (row != p && col != q) {
-					cofactor.matrix[i][j++] = matrix[row][col];
-					i += ((j == n - 1) ? 0 : j) == 0;
-				}
-			}
-		}
-		return cofactor;
+	int SequenceView::getDegree() const {
+		long long differences[Limits::MAX_EXPONENT + 1];
+		return getDegree(differences);
 	}
 
-	Matrix Matrix::getAdjoint() {
-		Matrix adj(n);
-		if (n == 1) {
-			adj.matrix[0][0] = 1;
-			return adj;
+	// Differences are taken in place in one per-thread scratch row, so repeated calls do not allocate.
+	// The leading differences are written to `differences`, whose size bounds the degree searched for. They are all that
+	// derivation and batch grouping read of the difference table, so no fuller table is kept
+	int SequenceView::getDegree(std::span<long long> differences) const {
+		thread_local std::vector<long long> scratch;
+		scratch.assign(elements.begin(), elements.end());
+		std::size_t count = scratch.size();
+		if (count == 0)
+			return 0;
+		for (int degree = 0;; degree++) {
+			differences[degree] = scratch[0];
+			if (!differenceInPlace(scratch.data(), count--))
+				return degree;
+			if (degree + 1 == (int)differences.size())
+				return INT_MAX;
 		}
-		int sign = 1;
-		for (int i = 0; i < n; i++)
-			for (int j = 0; j < n; j++)
-				adj.matrix[j][i] = (sign = ((i + j) % 2 == 0) ? 1 : -1) * (getCofactor(i, j).getDeterminant());
-		return adj;
 	}
 
-	Matrix Matrix::getInverse() {
-		Matrix adjoint = getAdjoint();
-		int det = getDeterminant();
-		Matrix inverse(n);
-		for (int row = 0; row < n; row++)
-			for (int col = 0; col < n; col++)
-				inverse.matrix[row][col] = (float) adjoint.matrix[row][col] / det;
-		return inverse;
+	std::string SequenceView::toString() const {
+		std::string text;
+		char buffer[12];
+		for (std::size_t i = 0; i < elements.size(); i++) {
+			if (i > 0)
+				text += ',';
+			text.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), elements[i]).ptr);
+		}
+		return text;
 	}
 
 	Sequence::Sequence() : elements() {
 		
 	}
 
-	Sequence::Sequence(std::vector<int> elements_) : elements(elements_), mIsLoaded(true) {
-
-	}
-
-	Sequence::Sequence(Sequence& other) {
-		*this = other;
-	}
-
-	Sequence& Sequence::operator=(Sequence& other) {
-		if (mIsLoaded = other.mIsLoaded)
-			elements = other.elements;
-		else
-			elements.clear();
-		return *this;
-	}
-
-	Sequence::Sequence(Sequence&& other) {
-		*this = std::move(other);
-	}
+	Sequence::Sequence(std::vector<int> elements_) : elements(std::move(elements_)), mIsLoaded(true) {
 
-	Sequence& Sequence::operator=(Sequence&& other) {
-		if (mIsLoaded = other.mIsLoaded)
-			elements = other.elements;
-		else
-			elements.clear();
-		return *this;
 	}
 
 	void Sequence::clear() {
@@ -107,44 +83,35 @@ namespace Algebra {
 			elements.push_back(i);
 	}
 
-	bool Sequence::parseFrom(std::string seqExpression) {
-		if (!isExpressionValid(seqExpression)) {
-			mCurrentErrorState = findExpressionError(seqExpression);
+	bool Sequence::parseFrom(std::string_view seqExpression) {
+		elements.clear();
+		if ((mCurrentErrorState = parseString(seqExpression, elements)) != NoError) {
+			elements.clear();
 			return mIsLoaded = false;
 		}
-		parseString(seqExpression, elements);
 		return mIsLoaded = true;
 	}
 
 	Sequence Sequence::differentiate() const {
-		std::vector<int> newElements{};
-		for (int i = 0; i < elements.size() - 1; i++)
-			newElements.push_back(elements[i + 1] - elements[i]);
-		return Sequence(newElements);
+		std::vector<int> newElements(elements.empty() ? 0 : elements.size() - 1);
+		for (std::size_t i = 0; i < newElements.size(); i++)
+			newElements[i] = elements[i + 1] - elements[i];
+		return Sequence(std::move(newElements));
 	}
 
 	int Sequence::getDegree() const {
-		Sequence differential = Sequence(elements);
-		int degree = 0;
-		while (true) {
-			if (std::adjacent_find(differential.elements.begin(), differential.elements.end(), std::not_equal_to<>() ) == differential.elements.end())
-				break;
-			differential = differential.differentiate();
-			if (degree++ > Limits::MAX_EXPONENT || differential.elements.empty())
-				return INT_MAX;
-		}
-		return degree;
+		return SequenceView(*this).getDegree();
+	}
+
+	int Sequence::getDegree(std::span<long long> differences) const {
+		return SequenceView(*this).getDegree(differences);
 	}
 
 	std::string Sequence::toString() const {
-		if (elements.empty()) return "";
-		std::ostringstream oss;
-		std::copy(elements.begin(), elements.end() - 1, std::ostream_iterator<int>(oss, ","));
-		oss << elements.back();
-		return oss.str();
+		return SequenceView(*this).toString();
 	}
 
-	std::string Sequence::getError() {
+	std::string Sequence::getError() const {
 		return ERROR_MESSAGES.find(mCurrentErrorState)->second;
 	}
 
@@ -152,168 +119,409 @@ namespace Algebra {
 		return mIsLoaded;
 	}
 
-	bool Sequence::isExpressionValid(std::string seqExpression) {
-		if (!std::regex_match(seqExpression, Regex::Validate::SEQUENCE))
-			return false;
-		return true;
+	// Single pass over: (element (',' element)+)?, where each element is parsed in place with std::from_chars
+	Sequence::ParseErrorState Sequence::parseString(std::string_view seqExpression, std::vector<int>& elements) {
+		if (seqExpression.empty())
+			return NoError;
+		// Rows are appended to a shared column, so growth must stay geometric: reserving exactly would copy the column per row
+		std::size_t required = elements.size() + std::count(seqExpression.begin(), seqExpression.end(), ',') + 1;
+		if (required > elements.capacity())
+			elements.reserve(std::max(required, 2 * elements.capacity()));
+		const char* first = seqExpression.data();
+		const char* last = first + seqExpression.size();
+		std::size_t parsed = 0;
+		while (true) {
+			int value;
+			auto [end, error] = std::from_chars(first, last, value);
+			if (error == std::errc::result_out_of_range)
+				return findUnknownSymbol(std::string_view(end, last - end), ElementOutOfRange);
+			if (error != std::errc())
+				return findUnknownSymbol(std::string_view(first, last - first), UnknownError);
+			elements.push_back(value);
+			parsed++;
+			if (end == last)
+				break;
+			if (*end != ',')
+				return findUnknownSymbol(std::string_view(end, last - end), UnknownError);
+			first = end + 1;
+		}
+		return (parsed < 2) ? UnknownError : NoError;
 	}
 
-	Sequence::ParseErrorState Sequence::findExpressionError(std::string seqExpression) const {
-		for (const auto& errorCheck : ERROR_CHECKS)
-			if (errorCheck.doCheck(seqExpression))
-				return errorCheck.state;
-		return UnknownError;
+	Sequence::ParseErrorState Sequence::findUnknownSymbol(std::string_view remainder, ParseErrorState fallback) {
+		return (remainder.find_first_not_of("0123456789,-") == std::string_view::npos) ? fallback : UnknownSymbol;
 	}
 
-	void Sequence::parseString(std::string seqExpression, std::vector<int>& elements) const {
-		elements.clear();
-		for (std::sregex_iterator i(seqExpression.begin(), seqExpression.end(), Regex::Search::SEQUENCE_ELEMENT); i != std::sregex_iterator(); i++) {
-			std::smatch m = *i;
-			std::string element = m[Regex::Search::ELEMENT_MATCH].str();
-			elements.push_back(stoi(element));
-		}
+	template<int MaxDegree>
+	BasicPolynomial<MaxDegree>::BasicPolynomial() : mCoefficients() {
+
+	}
+
+	template<int MaxDegree>
+	void BasicPolynomial<MaxDegree>::clear() {
+		std::fill_n(mCoefficients, MaxDegree + 1, 0);
+		mCurrentErrorState = NoError;
+		mIsLoaded = false;
+	}
+
+	template<int MaxDegree>
+	bool BasicPolynomial<MaxDegree>::parseFrom(std::string_view expression) {
+		int coeffs[MaxDegree + 1];
+		if ((mCurrentErrorState = parseExpression(expression, coeffs)) != NoError)
+			return mIsLoaded = false;
+		std::copy(std::begin(coeffs), std::end(coeffs), mCoefficients);
+		return mIsLoaded = true;
+	}
+
+	template<int MaxDegree>
+	template<std::size_t... Degrees>
+	constexpr std::array<typename BasicPolynomial<MaxDegree>::deriver_t, sizeof...(Degrees)> BasicPolynomial<MaxDegree>::makeDerivers(std::index_sequence<Degrees...>) {
+		return { &BasicPolynomial::template deriveWithDegree<(int)Degrees>... };
+	}
+
+	template<int MaxDegree>
+	bool BasicPolynomial<MaxDegree>::deriveFrom(SequenceView sequence) {
+		return deriveFrom(sequence, Analytic);
 	}
 
-	Polynomial::Polynomial() : mCoefficients() {
+	template<int MaxDegree>
+	bool BasicPolynomial<MaxDegree>::deriveFrom(SequenceView sequence, SearchStrategy strategy) {
+		SearchStatistics statistics;
+		return deriveFrom(sequence, strategy, statistics);
+	}
+
+	// The sequence's degree is measured once, then the search runs in a variant compiled for exactly that degree
+	template<int MaxDegree>
+	bool BasicPolynomial<MaxDegree>::deriveFrom(SequenceView sequence, SearchStrategy strategy, SearchStatistics& statistics) {
+		static constexpr std::array<deriver_t, MaxDegree + 1> DERIVERS = makeDerivers(std::make_index_sequence<MaxDegree + 1>());
+		// Any failure leaves the polynomial cleared and unloaded, not holding a previous result
 		clear();
+		if (sequence.elements.size() <= 2) return false;
+		long long differences[MaxDegree + 1]{};
+		int degree = sequence.getDegree(differences);
+		if (degree > MaxDegree) return false;
+		if ((this->*DERIVERS[degree])(sequence, differences, strategy, statistics)) return mIsLoaded = true;
+		// A rejected candidate may have left its coefficients behind
+		std::fill_n(mCoefficients, MaxDegree + 1, 0);
+		return false;
 	}
 
-	Polynomial::Polynomial(Polynomial& other) {
-		*this = other;
+	template<int MaxDegree>
+	template<int Degree>
+	bool BasicPolynomial<MaxDegree>::deriveWithDegree(SequenceView sequence, const long long (&differences)[MaxDegree + 1], SearchStrategy strategy, SearchStatistics& statistics) {
+		for (int step = 1; step < MAX_DERIVATION_STEP; step++) {
+			long long divided[MaxDegree + 1];
+			if (!getDividedDifferences<Degree>(differences, step, divided)) continue;
+			int lowest = -MAX_DERIVATION_OFFSET, highest = MAX_DERIVATION_OFFSET;
+			if (strategy == Analytic && !getOffsetRange<Degree>(divided, step, lowest, highest)) continue;
+			statistics.stepsTried++;
+			for (int i = 0; i <= highest - lowest; i++) {
+				int offset = getSearchOffset(strategy, i, lowest, highest);
+				statistics.candidatesExamined++;
+				if (strategy != Exhaustive && !isConstantInRange<Degree>(divided, offset, step)) continue;
+				statistics.candidatesExpanded++;
+				if (fitCandidate<Degree>(sequence, divided, offset, step)) return true;
+			}
+		}
+		return false;
 	}
 
-	Polynomial& Polynomial::operator=(Polynomial& other) {
-		if (mIsLoaded = other.mIsLoaded) {
-			for (int i = 0; i < Limits::MAX_EXPONENT + 1; i++)
-				mCoefficients[i] = other.mCoefficients[i];
+	template<int MaxDegree>
+	template<int Degree>
+	bool BasicPolynomial<MaxDegree>::fitCandidate(SequenceView sequence, const long long (&divided)[MaxDegree + 1], int offset, int step) {
+		long long expanded[MaxDegree + 1];
+		if (expandNewtonForm<Degree>(divided, offset, step, expanded)) {
+			if (std::any_of(expanded, expanded + Degree + 1, [](long long c) { return c > INT_MAX || c < INT_MIN; })) return false;
+			std::copy(std::begin(expanded), std::end(expanded), mCoefficients);
+		} else {
+			std::vector<int> coeffs = deriveEquations(Degree, sequence, offset, step);
+			if (coeffs.empty()) return false;
+			std::fill(std::copy(coeffs.begin(), coeffs.end(), mCoefficients), std::end(mCoefficients), 0);
+		}
+		return !doCoefficientsExeedMax(mCoefficients);
+	}
+
+	static long long floorDivide(long long numerator, long long denominator) {
+		long long quotient = numerator / denominator;
+		return (numerator % denominator != 0 && (numerator < 0) != (denominator < 0)) ? quotient - 1 : quotient;
+	}
+
+	static long long ceilDivide(long long numerator, long long denominator) {
+		return -floorDivide(-numerator, denominator);
+	}
+
+	// The leading coefficient is divided[Degree] whatever the offset. Below it, x^(Degree - 1) has the coefficient
+	// divided[Degree - 1] - divided[Degree] * sum(x[j], j < Degree), which is linear in the offset, so only a short run of
+	// offsets keeps it in range. For linear fits the same holds for the constant
+	template<int MaxDegree>
+	template<int Degree>
+	bool BasicPolynomial<MaxDegree>::getOffsetRange(const long long (&divided)[MaxDegree + 1], int step, int& lowest, int& highest) const {
+		long long lower = -MAX_DERIVATION_OFFSET, upper = MAX_DERIVATION_OFFSET;
+		if constexpr (Degree == 0) {
+			return divided[0] <= Limits::MAX_CONSTANT;
+		} else if constexpr (Degree == 1) {
+			if (std::abs(divided[1]) > Limits::MAX_COEFFICIENT)
+				return false;
+			// divided[0] - divided[1] * offset <= MAX_CONSTANT
+			long long bound = divided[0] - Limits::MAX_CONSTANT;
+			if (divided[1] > 0)
+				lower = std::max(lower, ceilDivide(bound, divided[1]));
+			else
+				upper = std::min(upper, floorDivide(bound, divided[1]));
 		} else {
-			std::fill_n(mCoefficients, Limits::MAX_EXPONENT + 1, 0);
+			if (std::abs(divided[Degree]) > Limits::MAX_COEFFICIENT)
+				return false;
+			// |target - slope * offset| <= MAX_COEFFICIENT
+			long long slope = divided[Degree] * Degree;
+			long long target = divided[Degree - 1] - divided[Degree] * step * (Degree * (Degree - 1) / 2);
+			long long first = target - Limits::MAX_COEFFICIENT, last = target + Limits::MAX_COEFFICIENT;
+			if (slope < 0)
+				std::swap(first, last);
+			lower = std::max(lower, ceilDivide(first, slope));
+			upper = std::min(upper, floorDivide(last, slope));
 		}
-		mCurrentErrorState = other.mCurrentErrorState;
-		return *this;
+		lowest = (int)lower;
+		highest = (int)upper;
+		return lowest <= highest;
+	}
+
+	// Evaluates the Newton form at x = 0, which is the constant term, in O(Degree) rather than expanding every coefficient.
+	// Terms too large to evaluate exactly are left for the full expansion to judge
+	template<int MaxDegree>
+	template<int Degree>
+	bool BasicPolynomial<MaxDegree>::isConstantInRange(const long long (&divided)[MaxDegree + 1], int offset, int step) const {
+		long long constant = divided[Degree];
+		for (int k = Degree - 1; k >= 0; k--) {
+			if (constant > MAX_NEWTON_TERM || constant < -MAX_NEWTON_TERM)
+				return true;
+			constant = divided[k] - (offset + (long long)k * step) * constant;
+		}
+		return constant <= Limits::MAX_CONSTANT && constant >= INT_MIN;
+	}
+
+	// Exhaustive and Analytic visit 0..highest and then lowest..-1; NearestFirst visits 0, 1, -1, 2, -2, ...
+	template<int MaxDegree>
+	int BasicPolynomial<MaxDegree>::getSearchOffset(SearchStrategy strategy, int i, int lowest, int highest) const {
+		if (strategy == NearestFirst)
+			return (i % 2 == 1) ? (i + 1) / 2 : -(i / 2);
+		int firstNonNegative = std::max(0, lowest);
+		int nonNegativeCount = std::max(0, highest - firstNonNegative + 1);
+		return (i < nonNegativeCount) ? firstNonNegative + i : lowest + (i - nonNegativeCount);
+	}
+
+	template<int MaxDegree>
+	std::string BasicPolynomial<MaxDegree>::toString() const {
+		char buffer[MAX_STRING_LENGTH];
+		return std::string(buffer, toChars(buffer));
+	}
+
+	// Writes the expression into [first, first + MAX_STRING_LENGTH) and returns one past its last character, so file
+	// output can format straight into its write block. A loaded polynomial with no terms is written as 0 so it can be
+	// told apart from, and read back unlike, no polynomial
+	template<int MaxDegree>
+	char* BasicPolynomial<MaxDegree>::toChars(char* first) const {
+		char* last = first + MAX_STRING_LENGTH;
+		char* cursor = first;
+		for (int exp = MaxDegree; exp >= 0; exp--) {
+			int coeff = mCoefficients[exp];
+			if (coeff == 0)
+				continue;
+			if (cursor != first)
+				cursor = std::copy_n((coeff < 0) ? " - " : " + ", 3, cursor);
+			else if (coeff < 0)
+				*cursor++ = '-';
+			unsigned int magnitude = (coeff < 0) ? 0u - (unsigned int)coeff : (unsigned int)coeff;
+			if (magnitude != 1 || exp == 0)
+				cursor = std::to_chars(cursor, last, magnitude).ptr;
+			if (exp == 0)
+				continue;
+			*cursor++ = 'x';
+			if (exp == 1)
+				continue;
+			*cursor++ = '^';
+			cursor = std::to_chars(cursor, last, exp).ptr;
+		}
+		if (cursor == first && mIsLoaded)
+			*cursor++ = '0';
+		return cursor;
 	}
 
-	Polynomial::Polynomial(Polynomial&& other) {
-		*this = std::move(other);
+	template<int MaxDegree>
+	std::string BasicPolynomial<MaxDegree>::getError() const {
+		return ERROR_MESSAGES.find(mCurrentErrorState)->second;
 	}
 
-	Polynomial& Polynomial::operator=(Polynomial&& other) {
-		if (mIsLoaded = other.mIsLoaded) {
-			for (int i = 0; i < Limits::MAX_EXPONENT + 1; i++)
-				mCoefficients[i] = other.mCoefficients[i];
-		} else {
-			std::fill_n(mCoefficients, Limits::MAX_EXPONENT + 1, 0);
-		}
-		mCurrentErrorState = other.mCurrentErrorState;
-		return *this;
+	template<int MaxDegree>
+	bool BasicPolynomial<MaxDegree>::isLoaded() const {
+		return mIsLoaded;
 	}
 
-	void Polynomial::clear() {
-		std::fill_n(mCoefficients, Limits::MAX_EXPONENT + 1, 0);
-		mCurrentErrorState = NoError;
-		mIsLoaded = false;
+	template<int MaxDegree>
+	int BasicPolynomial<MaxDegree>::getCoefficient(int exponent) const {
+		return mCoefficients[exponent];
 	}
 
-	bool Polynomial::parseFrom(std::string expression) {
-		expression.erase(remove(expression.begin(), expression.end(),' '), expression.end());
-		if (!isExpressionValid(expression)) {
-			mCurrentErrorState = findExpressionError(expression);
-			return mIsLoaded = false;
-		}
-		calculateCoefficients(expression, mCoefficients);
+	template<int MaxDegree>
+	int BasicPolynomial<MaxDegree>::getDegree() const {
+		int degree = MaxDegree;
+		while (degree > 0 && mCoefficients[degree] == 0)
+			degree--;
+		return degree;
+	}
+
+	template<int MaxDegree>
+	bool BasicPolynomial<MaxDegree>::setCoefficients(const int (&coeffs)[MaxDegree + 1]) {
+		if (doCoefficientsExeedMax(coeffs))
+			return false;
+		std::copy(std::begin(coeffs), std::end(coeffs), mCoefficients);
 		mCurrentErrorState = NoError;
 		return mIsLoaded = true;
 	}
 
-	bool Polynomial::deriveFrom(Sequence& sequence) {
-		if (sequence.elements.size() <= 2) return false;
-		int degree = sequence.getDegree();
-		if (degree > Limits::MAX_EXPONENT) return false;
-		int offset = 0, step = 1;
-		do {
-			std::vector<int> coeffs = deriveEquations(degree, sequence, offset, step);
-			std::copy(coeffs.begin(), coeffs.end(), mCoefficients);
-			if (!doCoefficientsExeedMax(mCoefficients)) return mIsLoaded = true;
-		} while ((step += (offset = (offset == MAX_DERIVATION_OFFSET ? -MAX_DERIVATION_OFFSET : offset + 1)) == 0 ? 1 : 0) != MAX_DERIVATION_STEP);
-		return false;
+	template<int MaxDegree>
+	void BasicPolynomial<MaxDegree>::apply(Sequence& sequence) const {
+		apply(sequence.elements.data(), sequence.elements.size());
 	}
 
-	std::string Polynomial::toString() const {
-		int exp = Limits::MAX_EXPONENT + 1;
-		return std::accumulate(std::rbegin(mCoefficients), std::rend(mCoefficients), std::string(),
-			[&exp](const std::string l, const int coeff) {
-				exp--;
-				return (coeff == 0) ? l : (l +
-					((l == "") ? ((coeff < 0) ? "-" : "") : ((coeff < 0) ? " - " : " + ")) +
-					((std::abs(coeff) == 1 && exp != 0) ? "" : std::to_string(std::abs(coeff))) +
-					((exp == 0) ? "" : ("x" + ((exp == 1) ? "" : ("^" + std::to_string(exp))))));
-			}
-		);
+	template<int MaxDegree>
+	void BasicPolynomial<MaxDegree>::apply(std::span<int> elements) const {
+		apply(elements.data(), elements.size());
 	}
 
-	std::string Polynomial::getError() const {
-		return ERROR_MESSAGES.find(mCurrentErrorState)->second;
+	template<int MaxDegree>
+	void BasicPolynomial<MaxDegree>::apply(int* elements, std::size_t count) const {
+		Kernel::applyHorner(mCoefficients, getDegree(), elements, count);
 	}
 
-	bool Polynomial::isLoaded() const {
-		return mIsLoaded;
-	}
+	// Single pass over: ['-'] term (('+' | '-') term)*, where term is [digit]x[^exponent] or a constant without leading zeros. Spaces are ignored anywhere
+	template<int MaxDegree>
+	typename BasicPolynomial<MaxDegree>::ParseErrorState BasicPolynomial<MaxDegree>::parseExpression(std::string_view expression, int (&coeffs)[MaxDegree + 1]) const {
+		std::fill_n(coeffs, MaxDegree + 1, 0);
+		std::size_t i = 0;
+		auto peek = [&]() {
+			while (i < expression.size() && expression[i] == ' ')
+				i++;
+			return (i < expression.size()) ? expression[i] : '\0';
+		};
+		auto readNumber = [&](int& digits) {
+			int value = 0;
+			for (digits = 0; peek() >= '0' && peek() <= '9'; digits++)
+				value = std::min(value * 10 + (expression[i++] - '0'), Limits::MAX_CONSTANT + 1);
+			return value;
+		};
 
-	void Polynomial::apply(Sequence& sequence) const {
-		for (auto& y : sequence.elements) {
-			int x = y;
-			y = 0;
-			for (int exp = 0; exp <= Limits::MAX_EXPONENT; exp++)
-				y += mCoefficients[exp] * std::pow(x, exp);
+		int sign = 1;
+		if (peek() == '-') {
+			sign = -1;
+			i++;
 		}
+		while (true) {
+			int digits;
+			bool hasLeadingZero = peek() == '0';
+			int value = readNumber(digits);
+			if (peek() == 'x') {
+				i++;
+				if (digits > 1)
+					return findUnknownSymbol(expression.substr(i), CoefficientTooLarge);
+				int exponent = 1;
+				if (peek() == '^') {
+					i++;
+					int exponentDigits;
+					bool exponentHasLeadingZero = peek() == '0';
+					exponent = readNumber(exponentDigits);
+					if (exponent > MaxDegree)
+						return findUnknownSymbol(expression.substr(i), ExponentTooLarge);
+					if (exponentDigits == 0 || (exponentDigits > 1 && exponentHasLeadingZero))
+						return findUnknownSymbol(expression.substr(i), UnknownError);
+				}
+				coeffs[exponent] += sign * ((digits == 0) ? 1 : value);
+			} else {
+				if (digits == 0 || (hasLeadingZero && digits > 1))
+					return findUnknownSymbol(expression.substr(i), UnknownError);
+				if (value > Limits::MAX_CONSTANT)
+					return findUnknownSymbol(expression.substr(i), ConstantTooLarge);
+				coeffs[0] += sign * value;
+			}
+			char separator = peek();
+			if (separator == '\0')
+				break;
+			if (separator != '+' && separator != '-')
+				return findUnknownSymbol(expression.substr(i), UnknownError);
+			sign = (separator == '-') ? -1 : 1;
+			i++;
+		}
+		if (!doCoefficientsExeedMax(coeffs))
+			return NoError;
+		return (coeffs[0] > Limits::MAX_CONSTANT) ? ConstantTooLarge : CoefficientTooLarge;
 	}
 
-	bool Polynomial::isExpressionValid(std::string expression) {
-		if (!std::regex_match(expression, Regex::Validate::POLYNOMIAL))
-			return false;
-		return !doCoefficientsExeedMax(expression);
+	template<int MaxDegree>
+	typename BasicPolynomial<MaxDegree>::ParseErrorState BasicPolynomial<MaxDegree>::findUnknownSymbol(std::string_view remainder, ParseErrorState fallback) const {
+		return (remainder.find_first_not_of("x0123456789^+- ") == std::string_view::npos) ? fallback : UnknownSymbol;
 	}
 
-	bool Polynomial::doCoefficientsExeedMax(const int (&coeffs)[Limits::MAX_EXPONENT + 1]) const {
+	template<int MaxDegree>
+	bool BasicPolynomial<MaxDegree>::doCoefficientsExeedMax(const int (&coeffs)[MaxDegree + 1]) const {
 		for (const auto& c : coeffs | std::views::drop(1))
 			if (c > Limits::MAX_COEFFICIENT || c < -Limits::MAX_COEFFICIENT)
 				return true;
 		return coeffs[0] > Limits::MAX_CONSTANT;
 	}
 
-	bool Polynomial::doCoefficientsExeedMax(std::string expression) const {
-		int coeffs[Limits::MAX_EXPONENT + 1]{};
-		calculateCoefficients(expression, coeffs);
-		return doCoefficientsExeedMax(coeffs);
-	}
-
-	Polynomial::ParseErrorState Polynomial::findExpressionError(std::string expression) const {
-		for (const auto& errorCheck : ERROR_CHECKS)
-			if (errorCheck.doCheck(expression))
-				return errorCheck.state;
-		return UnknownError;
+	// Newton forward form: y(x) = sum(f[k] * prod(x - x[j], j < k)) with nodes x[j] = offset + j * step and f[k] = diff[k] / (k! * step^k).
+	// At high degrees the denominator outgrows any difference an int sequence can produce, so once it would overflow
+	// only a zero difference can still divide exactly
+	template<int MaxDegree>
+	template<int Degree>
+	bool BasicPolynomial<MaxDegree>::getDividedDifferences(const long long (&differences)[MaxDegree + 1], int step, long long (&divided)[MaxDegree + 1]) const {
+		long long denominator = 1;
+		bool saturated = false;
+		for (int k = 0; k <= Degree; k++) {
+			if (k > 0 && !saturated && denominator > LLONG_MAX / ((long long)k * step))
+				saturated = true;
+			if (saturated) {
+				if (differences[k] != 0)
+					return false;
+				divided[k] = 0;
+				continue;
+			}
+			denominator *= (k == 0) ? 1 : (long long)k * step;
+			if (differences[k] % denominator != 0)
+				return false;
+			divided[k] = differences[k] / denominator;
+		}
+		return true;
 	}
 
-	void Polynomial::calculateCoefficients(std::string expression, int(&coeffs)[Limits::MAX_EXPONENT + 1]) const {
-		std::fill_n(coeffs, Limits::MAX_EXPONENT + 1, 0);
-		for (std::sregex_iterator i(expression.begin(), expression.end(), Regex::Search::POLYNOMIAL_COMPONENT); i != std::sregex_iterator(); i++) {
-			std::smatch m = *i;
-			std::string constValue = m[Regex::Search::COMPONENT_MATCH_CONSTANT].str();
-			std::string exponent = m[Regex::Search::COMPONENT_MATCH_EXPONENT].str();
-			std::string coefficient = m[Regex::Search::COMPONENT_MATCH_COEFFICIENT].str();
-			std::string sign = m[Regex::Search::COMPONENT_MATCH_SIGN].str();
-			coeffs[(constValue == "") ? (exponent == "") ? 1 : stoi(exponent) : 0] += ((coefficient == "" && constValue == "") ? 1 : stoi(constValue == "" ? coefficient : constValue)) * (sign == "-" ? -1 : 1);
+	template<int MaxDegree>
+	template<int Degree>
+	bool BasicPolynomial<MaxDegree>::expandNewtonForm(const long long (&divided)[MaxDegree + 1], int offset, int step, long long (&coeffs)[MaxDegree + 1]) const {
+		std::fill_n(coeffs, MaxDegree + 1, 0);
+		coeffs[0] = divided[Degree];
+		for (int k = Degree - 1; k >= 0; k--) {
+			if (std::any_of(coeffs, coeffs + Degree - k, [](long long c) { return c > MAX_NEWTON_TERM || c < -MAX_NEWTON_TERM; }))
+				return false;
+			long long node = offset + (long long)k * step;
+			for (int exp = Degree - k; exp >= 0; exp--)
+				coeffs[exp] = ((exp > 0) ? coeffs[exp - 1] : 0) - node * coeffs[exp];
+			coeffs[0] += divided[k];
 		}
+		return true;
 	}
 
-	std::vector<int> Polynomial::deriveEquations(const int degree, Sequence& sequence, int offset, int step) {
-		Matrix simultaniousLHS(degree + 1);
-		std::vector<float> simultaniousRHS(sequence.elements.begin(), sequence.elements.begin() + degree + 1);
-		for (int i = 0; i < degree + 1; i++)
-			for (int exp = 0; exp < degree + 1; exp++)
-				simultaniousLHS.matrix[i][exp] = std::pow(i + offset, exp);
-		Matrix inverse = simultaniousLHS.getInverse();
-		std::vector<float> coeffs = inverse * simultaniousRHS;
-		return std::accumulate(coeffs.begin(), coeffs.end(), std::vector<int>(), [](std::vector<int> vec, float n) { vec.push_back((int)std::round(n)); return vec; });
+	template<int MaxDegree>
+	std::vector<int> BasicPolynomial<MaxDegree>::deriveEquations(const int degree, SequenceView sequence, int offset, int step) {
+		Matrix<Rational> scratch(0);
+		const Matrix<Rational>* inverse = VandermondeCache::instance().getInverse(degree, offset, step, scratch);
+		if (inverse == nullptr)
+			return {};
+		// A product that overflowed leaves an invalid coefficient, which rejects the candidate like a fractional one
+		std::vector<Rational> coeffs = *inverse * std::vector<Rational>(sequence.elements.begin(), sequence.elements.begin() + degree + 1);
+		if (!std::all_of(coeffs.begin(), coeffs.end(), [](const Rational& c) { return c.isValid() && c.isInteger() && c.numerator >= INT_MIN && c.numerator <= INT_MAX; }))
+			return {};
+		return std::accumulate(coeffs.begin(), coeffs.end(), std::vector<int>(), [](std::vector<int> vec, const Rational& n) { vec.push_back((int)n.numerator); return vec; });
 	}
+
+	template class BasicPolynomial<Limits::MAX_EXPONENT>;
+	template class BasicPolynomial<Limits::MAX_SUPPORTED_EXPONENT>;
 }
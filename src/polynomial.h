@@ -1,68 +1,64 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <functional>
 #include <map>
-#include <regex>
+#include <span>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
-namespace Algebra {
-	namespace Regex {
-		namespace Validate {
-			const std::regex POLYNOMIAL("^-?(([0-9]?x(\\^[0-4])?)|([1-9]|[1-9][0-9]|[1-9][0-9][0-9]|1000))((\\+|-)(([0-9]?x(\\^[0-4])?)|([1-9]|[1-9][0-9]|[1-9][0-9][0-9]|1000)))*$");
-			const std::regex SEQUENCE("^(-?[0-9]+(,-?[0-9]+)+)?$");
-		}
-		namespace Search {
-			const std::regex POLYNOMIAL_COMPONENT("(?=(^|\\+|-)(([0-9]+)|(([0-9]*)x(\\^([0-9]+))?))($|\\+|-))");
-			const int COMPONENT_MATCH_SIGN        = 1;
-			const int COMPONENT_MATCH_COEFFICIENT = 5;
-			const int COMPONENT_MATCH_EXPONENT    = 7;
-			const int COMPONENT_MATCH_CONSTANT    = 3;
-			const std::regex SEQUENCE_ELEMENT("(?=(^|,)(-?[0-9]+)(,|$))");
-			const int ELEMENT_MATCH = 2;
-		}
-		namespace Error {
-			const std::regex POLYNOMIAL_UNKNOWN_SYMBOL = std::regex("[^x0-9\\^+-]");
-			const std::regex SEQUENCE_UNKNOWN_SYMBOL = std::regex("[^0-9,-]");
-		}
-	}
+#include "matrix.h"
+#include "rational.h"
 
+namespace Algebra {
 	namespace Limits {
 		const int MAX_CONSTANT = 1000;
 		const int MAX_COEFFICIENT = 9;
 		const int MAX_EXPONENT = 4;
+		// Highest degree a sequence of ints can reach within the coefficient limits: x^12 - 9x^10 stays in range at
+		// -6..6, but every degree 13 polynomial leaves int somewhere on any 14 equally spaced nodes
+		const int MAX_SUPPORTED_EXPONENT = 12;
 	}
 
-	struct Matrix {
-		Matrix(int n_);
-		std::vector<float> operator*(std::vector<float> vec);
-
-		int getDeterminant();
-		Matrix getCofactor(int p, int q);
-		Matrix getAdjoint();
-		Matrix getInverse();
-		
-		int n;
-		std::vector<std::vector<float>> matrix;
+	class Sequence;
+	class SequenceSet;
+
+	// Read-only view of a sequence's elements, owned either by a Sequence or by one row of a SequenceSet
+	class SequenceView {
+	public:
+		SequenceView(std::span<const int> elements_);
+		SequenceView(const Sequence& sequence);
+
+		int getDegree() const;
+		int getDegree(std::span<long long> differences) const;
+		std::string toString() const;
+
+		std::span<const int> elements;
 	};
 
 	class Sequence {
 	public:
 		Sequence();
 		explicit Sequence(std::vector<int> elements_);
-		Sequence(Sequence& other);
-		Sequence& operator=(Sequence& other);
-		Sequence(Sequence&& other);
-		Sequence& operator=(Sequence&& other);
+		Sequence(const Sequence& other) = default;
+		Sequence& operator=(const Sequence& other) = default;
+		Sequence(Sequence&& other) noexcept = default;
+		Sequence& operator=(Sequence&& other) noexcept = default;
 
 		void clear();
 		void generateFrom(int start, int end, int step);
-		bool parseFrom(std::string seqExpression);
+		bool parseFrom(std::string_view seqExpression);
 
 		Sequence differentiate() const;
 		int getDegree() const;
+		int getDegree(std::span<long long> differences) const;
 		std::string toString() const;
 
-		std::string getError();
+		std::string getError() const;
 		bool isLoaded() const;
 
 		std::vector<int> elements;
@@ -70,91 +66,134 @@ namespace Algebra {
 		enum ParseErrorState {
 			NoError,
 			UnknownSymbol,
+			ElementOutOfRange,
 			UnknownError
 		};
-		bool isExpressionValid(std::string seqExpression);
-		ParseErrorState findExpressionError(std::string seqExpression) const;
+		static ParseErrorState parseString(std::string_view seqExpression, std::vector<int>& elements);
+		static ParseErrorState findUnknownSymbol(std::string_view remainder, ParseErrorState fallback);
 
-		void parseString(std::string seqExpression, std::vector<int>& elements) const;
+		friend class SequenceSet;
 
 		bool mIsLoaded = false;
 
 		ParseErrorState mCurrentErrorState = NoError;
 
-		const std::regex UNKNOWN_SYMBOL = std::regex("[^x1-9\\^+-]");
-		const std::map<ParseErrorState, std::string> ERROR_MESSAGES = {
+		inline static const std::map<ParseErrorState, std::string> ERROR_MESSAGES = {
 			{NoError, ""},
 			{UnknownSymbol, "Unknown Symbol - One or more characters not recognized"},
+			{ElementOutOfRange, "Element Out Of Range - One or more elements are too large to store"},
 			{UnknownError, "Unknown Error"}
 		};
+	};
 
-		typedef std::function<bool(std::string)> error_check_t;
-		struct ErrorCheck {
-			ParseErrorState state;
-			error_check_t doCheck;
-		};
-		const std::vector<ErrorCheck> ERROR_CHECKS = {
-			{UnknownSymbol, [this](std::string expression) { return std::regex_match(expression, Regex::Error::SEQUENCE_UNKNOWN_SYMBOL); }},
-		};
+	// Order in which deriveFrom visits (step, offset) candidates, where sequence element k is read as p(offset + k * step).
+	// Exhaustive tries every offset of every step in full. NearestFirst tries offsets by distance from zero and rejects a
+	// candidate from its constant term before expanding it. Analytic rejects steps whose leading coefficient is out of
+	// range and offsets whose x^(degree - 1) coefficient is, then visits the rest in exhaustive order, so it finds the
+	// same fit as Exhaustive after a handful of candidates
+	enum SearchStrategy {
+		Exhaustive,
+		NearestFirst,
+		Analytic,
+	};
+
+	struct SearchStatistics {
+		std::size_t stepsTried = 0;
+		std::size_t candidatesExamined = 0;
+		std::size_t candidatesExpanded = 0;
 	};
 
-	class Polynomial {
+	// Polynomial with integer coefficients up to x^MaxDegree. Instantiated for Limits::MAX_EXPONENT, the default used
+	// throughout, and Limits::MAX_SUPPORTED_EXPONENT for higher-degree fits
+	template<int MaxDegree>
+	class BasicPolynomial {
 	public:
-		Polynomial();
-		Polynomial(Polynomial& other);
-		Polynomial& operator=(Polynomial& other);
-		Polynomial(Polynomial&& other);
-		Polynomial& operator=(Polynomial&& other);
+		static_assert(MaxDegree >= 0 && MaxDegree <= Limits::MAX_SUPPORTED_EXPONENT, "Unsupported maximum degree");
+
+		BasicPolynomial();
+		BasicPolynomial(const BasicPolynomial& other) = default;
+		BasicPolynomial& operator=(const BasicPolynomial& other) = default;
+		BasicPolynomial(BasicPolynomial&& other) noexcept = default;
+		BasicPolynomial& operator=(BasicPolynomial&& other) noexcept = default;
 
 		void clear();
-		bool parseFrom(std::string expression);
-		bool deriveFrom(Sequence& sequence);
+		bool parseFrom(std::string_view expression);
+		bool deriveFrom(SequenceView sequence);
+		bool deriveFrom(SequenceView sequence, SearchStrategy strategy);
+		bool deriveFrom(SequenceView sequence, SearchStrategy strategy, SearchStatistics& statistics);
 		std::string toString() const;
+		char* toChars(char* first) const;
 
 		std::string getError() const;
 		bool isLoaded() const;
 
+		int getCoefficient(int exponent) const;
+		int getDegree() const;
+		bool setCoefficients(const int (&coeffs)[MaxDegree + 1]);
+
 		void apply(Sequence& sequence) const;
+		void apply(std::span<int> elements) const;
+		void apply(int* elements, std::size_t count) const;
+
+		// Longest text toChars can write: every term as " - " then ten digits, "x^" and a two digit exponent
+		static constexpr std::size_t MAX_STRING_LENGTH = (MaxDegree + 1) * 17;
 	private:
 		enum ParseErrorState {
 			NoError,
 			UnknownSymbol,
 			CoefficientTooLarge,
 			ConstantTooLarge,
+			ExponentTooLarge,
 			UnknownError
 		};
-		bool isExpressionValid(std::string expression);
-		bool doCoefficientsExeedMax(const int (&coeffs)[Limits::MAX_EXPONENT + 1]) const;
-		bool doCoefficientsExeedMax(std::string expression) const;
-		ParseErrorState findExpressionError(std::string expression) const;
-
-		void calculateCoefficients(std::string expression, int (&coeffs)[Limits::MAX_EXPONENT + 1]) const;
-
-		std::vector<int> deriveEquations(const int degree, Sequence& sequence, int offset, int step);
-
-		int mCoefficients[Limits::MAX_EXPONENT + 1];
+		ParseErrorState parseExpression(std::string_view expression, int (&coeffs)[MaxDegree + 1]) const;
+		ParseErrorState findUnknownSymbol(std::string_view remainder, ParseErrorState fallback) const;
+		bool doCoefficientsExeedMax(const int (&coeffs)[MaxDegree + 1]) const;
+
+		typedef bool (BasicPolynomial::*deriver_t)(SequenceView, const long long (&)[MaxDegree + 1], SearchStrategy, SearchStatistics&);
+		template<std::size_t... Degrees>
+		static constexpr std::array<deriver_t, sizeof...(Degrees)> makeDerivers(std::index_sequence<Degrees...>);
+		template<int Degree>
+		bool deriveWithDegree(SequenceView sequence, const long long (&differences)[MaxDegree + 1], SearchStrategy strategy, SearchStatistics& statistics);
+		template<int Degree>
+		bool fitCandidate(SequenceView sequence, const long long (&divided)[MaxDegree + 1], int offset, int step);
+
+		template<int Degree>
+		bool getOffsetRange(const long long (&divided)[MaxDegree + 1], int step, int& lowest, int& highest) const;
+		template<int Degree>
+		bool isConstantInRange(const long long (&divided)[MaxDegree + 1], int offset, int step) const;
+		int getSearchOffset(SearchStrategy strategy, int i, int lowest, int highest) const;
+
+		template<int Degree>
+		bool getDividedDifferences(const long long (&differences)[MaxDegree + 1], int step, long long (&divided)[MaxDegree + 1]) const;
+		template<int Degree>
+		bool expandNewtonForm(const long long (&divided)[MaxDegree + 1], int offset, int step, long long (&coeffs)[MaxDegree + 1]) const;
+		std::vector<int> deriveEquations(const int degree, SequenceView sequence, int offset, int step);
+
+		int mCoefficients[MaxDegree + 1];
 		bool mIsLoaded = false;
 
 		ParseErrorState mCurrentErrorState = NoError;
 
-		const int MAX_DERIVATION_OFFSET = 500;
-		const int MAX_DERIVATION_STEP = 20;
+		static constexpr int MAX_DERIVATION_OFFSET = 500;
+		static constexpr int MAX_DERIVATION_STEP = 20;
+		static constexpr long long MAX_NEWTON_TERM = 1LL << 50;
 
-		const std::map<ParseErrorState, std::string> ERROR_MESSAGES = {
+		inline static const std::map<ParseErrorState, std::string> ERROR_MESSAGES = {
 			{NoError, ""},
 			{UnknownSymbol, "Unknown Symbol - One or more characters not recognized"},
 			{CoefficientTooLarge, "Coefficient Too Large - One or more coefficients are larger than the maximum"},
+			{ConstantTooLarge, "Constant Too Large - The constant is larger than the maximum"},
+			{ExponentTooLarge, "Exponent Too Large - One or more exponents are larger than the maximum"},
 			{UnknownError, "Unknown Error"}
 		};
-
-		typedef std::function<bool(std::string)> error_check_t;
-		struct ErrorCheck {
-			ParseErrorState state;
-			error_check_t doCheck;
-		};
-		const std::vector<ErrorCheck> ERROR_CHECKS = {
-			{UnknownSymbol, [this](std::string expression) { return std::regex_match(expression, Regex::Error::POLYNOMIAL_UNKNOWN_SYMBOL); }},
-			{CoefficientTooLarge, [this](std::string expression) { return doCoefficientsExeedMax(expression); }},
-		};
 	};
+
+	extern template class BasicPolynomial<Limits::MAX_EXPONENT>;
+	extern template class BasicPolynomial<Limits::MAX_SUPPORTED_EXPONENT>;
+
+	typedef BasicPolynomial<Limits::MAX_EXPONENT> Polynomial;
+
+	static_assert(std::is_nothrow_move_constructible_v<Sequence> && std::is_nothrow_move_constructible_v<Polynomial>,
+		"Sequence and Polynomial must relocate without copying when their vectors grow");
 }
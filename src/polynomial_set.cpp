@@ -0,0 +1,95 @@
+#include "polynomial_set.h"
+
+#include <algorithm>
+
+#include "apply_kernel.h"
+
+namespace Algebra {
+	PolynomialSet::PolynomialSet() : mColumns() {
+
+	}
+
+	PolynomialSet::PolynomialSet(std::span<const Polynomial> polynomials) : mColumns() {
+		for (auto& column : mColumns)
+			column.reserve(polynomials.size());
+		for (const auto& polynomial : polynomials)
+			pushBack(polynomial);
+	}
+
+	std::size_t PolynomialSet::size() const {
+		return mColumns[0].size();
+	}
+
+	bool PolynomialSet::empty() const {
+		return size() == 0;
+	}
+
+	int PolynomialSet::getMaxDegree() const {
+		return mMaxDegree;
+	}
+
+	int PolynomialSet::getCoefficient(std::size_t i, int exponent) const {
+		return mColumns[exponent][i];
+	}
+
+	Polynomial PolynomialSet::getPolynomial(std::size_t i) const {
+		int coeffs[Limits::MAX_EXPONENT + 1];
+		for (int exp = 0; exp <= Limits::MAX_EXPONENT; exp++)
+			coeffs[exp] = mColumns[exp][i];
+		Polynomial polynomial;
+		polynomial.setCoefficients(coeffs);
+		return polynomial;
+	}
+
+	void PolynomialSet::clear() {
+		for (auto& column : mColumns)
+			column.clear();
+		mMaxDegree = 0;
+	}
+
+	void PolynomialSet::pushBack(const Polynomial& polynomial) {
+		for (int exp = 0; exp <= Limits::MAX_EXPONENT; exp++)
+			mColumns[exp].push_back(polynomial.getCoefficient(exp));
+		mMaxDegree = std::max(mMaxDegree, polynomial.getDegree());
+	}
+
+	void PolynomialSet::erase(std::size_t i) {
+		for (auto& column : mColumns)
+			column.erase(column.begin() + i);
+		updateMaxDegree();
+	}
+
+	// Columns above the highest degree in the set are all zero, so Horner starts from mMaxDegree
+	void PolynomialSet::evaluateAt(int x, std::span<int> results) const {
+		const int* columns[Limits::MAX_EXPONENT + 1];
+		for (int exp = 0; exp <= Limits::MAX_EXPONENT; exp++)
+			columns[exp] = mColumns[exp].data();
+		Kernel::evaluateColumns(columns, mMaxDegree, x, results.data(), std::min(results.size(), size()));
+	}
+
+	void PolynomialSet::apply(std::size_t i, std::span<int> elements) const {
+		getPolynomial(i).apply(elements);
+	}
+
+	// Polynomial p matches when applying it to the nodes offset + k * step reproduces the sequence's elements; values
+	// wrap exactly as Polynomial::apply does
+	std::size_t PolynomialSet::findMatches(SequenceView sequence, int offset, int step, std::vector<unsigned char>& isMatch) const {
+		isMatch.assign(size(), 1);
+		thread_local std::vector<int> values;
+		values.resize(size());
+		for (std::size_t k = 0; k < sequence.elements.size(); k++) {
+			evaluateAt(offset + (int)k * step, values);
+			int expected = sequence.elements[k];
+			for (std::size_t p = 0; p < values.size(); p++)
+				isMatch[p] &= (unsigned char)(values[p] == expected);
+		}
+		return std::count(isMatch.begin(), isMatch.end(), 1);
+	}
+
+	void PolynomialSet::updateMaxDegree() {
+		mMaxDegree = 0;
+		for (int exp = Limits::MAX_EXPONENT; exp > 0 && mMaxDegree == 0; exp--)
+			if (std::any_of(mColumns[exp].begin(), mColumns[exp].end(), [](int c) { return c != 0; }))
+				mMaxDegree = exp;
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "polynomial.h"
+
+namespace Algebra {
+	// Structure-of-arrays storage for many polynomials: column k holds every polynomial's x^k coefficient, so a single
+	// input is evaluated against the whole set with SIMD lanes running across polynomials
+	class PolynomialSet {
+	public:
+		PolynomialSet();
+		explicit PolynomialSet(std::span<const Polynomial> polynomials);
+
+		std::size_t size() const;
+		bool empty() const;
+		int getMaxDegree() const;
+
+		int getCoefficient(std::size_t i, int exponent) const;
+		Polynomial getPolynomial(std::size_t i) const;
+
+		void clear();
+		void pushBack(const Polynomial& polynomial);
+		void erase(std::size_t i);
+
+		void evaluateAt(int x, std::span<int> results) const;
+		void apply(std::size_t i, std::span<int> elements) const;
+		std::size_t findMatches(SequenceView sequence, int offset, int step, std::vector<unsigned char>& isMatch) const;
+	private:
+		void updateMaxDegree();
+
+		std::vector<int> mColumns[Limits::MAX_EXPONENT + 1];
+		int mMaxDegree = 0;
+	};
+}
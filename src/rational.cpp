@@ -0,0 +1,123 @@
+#include "rational.h"
+
+#include <climits>
+#include <cstdlib>
+#include <numeric>
+
+namespace Algebra {
+	// Valid values never hold LLONG_MIN (normalize rejects it), so negation is safe and magnitudes fit in long long
+	static bool checkedAdd(long long a, long long b, long long& result) {
+#if defined(__GNUC__) || defined(__clang__)
+		return !__builtin_add_overflow(a, b, &result);
+#else
+		if ((b > 0 && a > LLONG_MAX - b) || (b < 0 && a < LLONG_MIN - b))
+			return false;
+		result = a + b;
+		return true;
+#endif
+	}
+
+	static bool checkedMultiply(long long a, long long b, long long& result) {
+#if defined(__GNUC__) || defined(__clang__)
+		return !__builtin_mul_overflow(a, b, &result);
+#else
+		if (a != 0 && std::llabs(b) > LLONG_MAX / std::llabs(a))
+			return false;
+		result = a * b;
+		return true;
+#endif
+	}
+
+	Rational::Rational(long long numerator_, long long denominator_) : numerator(numerator_), denominator(denominator_) {
+		normalize();
+	}
+
+	Rational Rational::operator+(const Rational& other) const {
+		if (!isValid() || !other.isValid())
+			return Rational(0, 0);
+		long long g = std::gcd(denominator, other.denominator);
+		long long left, right, sum, product;
+		if (!checkedMultiply(numerator, other.denominator / g, left) || !checkedMultiply(other.numerator, denominator / g, right)
+			|| !checkedAdd(left, right, sum) || !checkedMultiply(denominator / g, other.denominator, product))
+			return Rational(0, 0);
+		return Rational(sum, product);
+	}
+
+	Rational Rational::operator-(const Rational& other) const {
+		return *this + -other;
+	}
+
+	Rational Rational::operator*(const Rational& other) const {
+		if (!isValid() || !other.isValid())
+			return Rational(0, 0);
+		long long g1 = std::gcd(numerator, other.denominator);
+		long long g2 = std::gcd(other.numerator, denominator);
+		g1 = (g1 == 0) ? 1 : g1;
+		g2 = (g2 == 0) ? 1 : g2;
+		long long product, denominatorProduct;
+		if (!checkedMultiply(numerator / g1, other.numerator / g2, product) || !checkedMultiply(denominator / g2, other.denominator / g1, denominatorProduct))
+			return Rational(0, 0);
+		return Rational(product, denominatorProduct);
+	}
+
+	Rational Rational::operator/(const Rational& other) const {
+		return *this * Rational(other.denominator, other.numerator);
+	}
+
+	Rational Rational::operator-() const {
+		return Rational(-numerator, denominator);
+	}
+
+	Rational& Rational::operator+=(const Rational& other) {
+		return *this = *this + other;
+	}
+
+	Rational& Rational::operator-=(const Rational& other) {
+		return *this = *this - other;
+	}
+
+	Rational& Rational::operator*=(const Rational& other) {
+		return *this = *this * other;
+	}
+
+	Rational& Rational::operator/=(const Rational& other) {
+		return *this = *this / other;
+	}
+
+	bool Rational::operator==(const Rational& other) const {
+		return numerator == other.numerator && denominator == other.denominator;
+	}
+
+	bool Rational::operator<(const Rational& other) const {
+		return (*this - other).numerator < 0;
+	}
+
+	bool Rational::isInteger() const {
+		return denominator == 1;
+	}
+
+	bool Rational::isValid() const {
+		return denominator != 0;
+	}
+
+	void Rational::normalize() {
+		if (denominator == 0 || numerator == LLONG_MIN || denominator == LLONG_MIN) {
+			numerator = 0;
+			denominator = 0;
+			return;
+		}
+		if (denominator < 0) {
+			numerator = -numerator;
+			denominator = -denominator;
+		}
+		long long g = std::gcd(numerator, denominator);
+		if (g > 1) {
+			numerator /= g;
+			denominator /= g;
+		}
+	}
+
+	Rational abs(const Rational& value) {
+		return (value.numerator < 0) ? -value : value;
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+namespace Algebra {
+	// Exact fraction over long long. Arithmetic whose result does not fit leaves an invalid value (zero denominator)
+	// instead of overflowing; invalid values stay invalid through further arithmetic and are never integers
+	struct Rational {
+		Rational(long long numerator_ = 0, long long denominator_ = 1);
+
+		Rational operator+(const Rational& other) const;
+		Rational operator-(const Rational& other) const;
+		Rational operator*(const Rational& other) const;
+		Rational operator/(const Rational& other) const;
+		Rational operator-() const;
+
+		Rational& operator+=(const Rational& other);
+		Rational& operator-=(const Rational& other);
+		Rational& operator*=(const Rational& other);
+		Rational& operator/=(const Rational& other);
+
+		bool operator==(const Rational& other) const;
+		bool operator<(const Rational& other) const;
+
+		bool isInteger() const;
+		bool isValid() const;
+
+		long long numerator;
+		long long denominator;
+	private:
+		void normalize();
+	};
+
+	Rational abs(const Rational& value);
+}
@@ -0,0 +1,134 @@
+#include "sequence_set.h"
+
+#include <algorithm>
+
+namespace Algebra {
+	SequenceSet::SequenceSet() noexcept : mElements(), mOffsets() {
+
+	}
+
+	// Moves go through swap, so the moved-from set is left with no offsets, which is the empty set
+	SequenceSet::SequenceSet(SequenceSet&& other) noexcept : SequenceSet() {
+		swap(other);
+	}
+
+	SequenceSet& SequenceSet::operator=(SequenceSet&& other) noexcept {
+		if (this != &other) {
+			SequenceSet moved(std::move(other));
+			swap(moved);
+		}
+		return *this;
+	}
+
+	std::size_t SequenceSet::size() const {
+		return mOffsets.empty() ? 0 : mOffsets.size() - 1;
+	}
+
+	bool SequenceSet::empty() const {
+		return size() == 0;
+	}
+
+	std::size_t SequenceSet::getElementCount() const {
+		return mElements.size();
+	}
+
+	SequenceView SequenceSet::operator[](std::size_t i) const {
+		return SequenceView(std::span<const int>(mElements.data() + mOffsets[i], mOffsets[i + 1] - mOffsets[i]));
+	}
+
+	std::span<int> SequenceSet::getElements(std::size_t i) {
+		return std::span<int>(mElements.data() + mOffsets[i], mOffsets[i + 1] - mOffsets[i]);
+	}
+
+	std::span<int> SequenceSet::getAllElements() {
+		return mElements;
+	}
+
+	std::span<const int> SequenceSet::getAllElements() const {
+		return mElements;
+	}
+
+	Sequence SequenceSet::getSequence(std::size_t i) const {
+		std::span<const int> elements = (*this)[i].elements;
+		return Sequence(std::vector<int>(elements.begin(), elements.end()));
+	}
+
+	void SequenceSet::reserve(std::size_t sequenceCount, std::size_t elementCount) {
+		mOffsets.reserve(sequenceCount + 1);
+		mElements.reserve(elementCount);
+	}
+
+	void SequenceSet::clear() {
+		mElements.clear();
+		mOffsets.clear();
+	}
+
+	void SequenceSet::pushBack(std::span<const int> elements) {
+		mElements.insert(mElements.end(), elements.begin(), elements.end());
+		pushOffset();
+	}
+
+	// Parses straight into the element column, rolling it back if the expression is malformed
+	bool SequenceSet::parseBack(std::string_view seqExpression) {
+		std::size_t begin = mElements.size();
+		if (Sequence::parseString(seqExpression, mElements) != Sequence::NoError) {
+			mElements.resize(begin);
+			return false;
+		}
+		pushOffset();
+		return true;
+	}
+
+	void SequenceSet::append(const SequenceSet& other) {
+		if (other.empty())
+			return;
+		if (mOffsets.empty())
+			mOffsets.push_back(0);
+		std::size_t base = mElements.size();
+		mElements.insert(mElements.end(), other.mElements.begin(), other.mElements.end());
+		mOffsets.reserve(mOffsets.size() + other.size());
+		for (std::size_t i = 1; i < other.mOffsets.size(); i++)
+			mOffsets.push_back(base + other.mOffsets[i]);
+	}
+
+	void SequenceSet::append(SequenceSet&& other) {
+		if (empty())
+			*this = std::move(other);
+		else
+			append(other);
+	}
+
+	void SequenceSet::erase(std::size_t i) {
+		std::size_t length = mOffsets[i + 1] - mOffsets[i];
+		mElements.erase(mElements.begin() + mOffsets[i], mElements.begin() + mOffsets[i + 1]);
+		mOffsets.erase(mOffsets.begin() + i + 1);
+		std::for_each(mOffsets.begin() + i + 1, mOffsets.end(), [length](std::size_t& offset) { offset -= length; });
+	}
+
+	void SequenceSet::truncate(std::size_t sequenceCount) {
+		if (sequenceCount >= size())
+			return;
+		mOffsets.resize(sequenceCount + 1);
+		mElements.resize(mOffsets.back());
+	}
+
+	void SequenceSet::swap(SequenceSet& other) noexcept {
+		mElements.swap(other.mElements);
+		mOffsets.swap(other.mOffsets);
+	}
+
+	// Appends a zeroed sequence of the given length and returns its elements for the caller to fill
+	std::span<int> SequenceSet::resizeBack(std::size_t elementCount) {
+		std::size_t begin = mElements.size();
+		mElements.resize(begin + elementCount);
+		pushOffset();
+		return std::span<int>(mElements.data() + begin, elementCount);
+	}
+
+	// Closes the sequence ending at the back of the element column, adding the leading offset first if this is the first one
+	void SequenceSet::pushOffset() {
+		if (mOffsets.empty())
+			mOffsets.push_back(0);
+		mOffsets.push_back(mElements.size());
+	}
+}
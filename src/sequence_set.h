@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "polynomial.h"
+
+namespace Algebra {
+	// Compressed row storage for many sequences: every element lives in one contiguous column and sequence i spans
+	// [offsets[i], offsets[i + 1]). Rows are handed out as spans or SequenceViews, which stay valid until the set is modified.
+	// An empty set holds no offsets at all; the leading zero offset is added with the first sequence, so construction and
+	// moves never allocate
+	class SequenceSet {
+	public:
+		SequenceSet() noexcept;
+		SequenceSet(const SequenceSet& other) = default;
+		SequenceSet& operator=(const SequenceSet& other) = default;
+		SequenceSet(SequenceSet&& other) noexcept;
+		SequenceSet& operator=(SequenceSet&& other) noexcept;
+
+		std::size_t size() const;
+		bool empty() const;
+		std::size_t getElementCount() const;
+
+		SequenceView operator[](std::size_t i) const;
+		std::span<int> getElements(std::size_t i);
+		std::span<int> getAllElements();
+		std::span<const int> getAllElements() const;
+		Sequence getSequence(std::size_t i) const;
+
+		void reserve(std::size_t sequenceCount, std::size_t elementCount);
+		void clear();
+		void pushBack(std::span<const int> elements);
+		bool parseBack(std::string_view seqExpression);
+		void append(const SequenceSet& other);
+		void append(SequenceSet&& other);
+		void erase(std::size_t i);
+		void truncate(std::size_t sequenceCount);
+		void swap(SequenceSet& other) noexcept;
+
+		std::span<int> resizeBack(std::size_t elementCount);
+	private:
+		void pushOffset();
+
+		std::vector<int> mElements;
+		std::vector<std::size_t> mOffsets;
+	};
+
+	static_assert(std::is_nothrow_move_constructible_v<SequenceSet> && std::is_nothrow_move_assignable_v<SequenceSet>,
+		"SequenceSet must relocate without copying when a vector of sets grows");
+}
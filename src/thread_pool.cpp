@@ -0,0 +1,89 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int workerCount) {
+	startWorkers(workerCount);
+}
+
+ThreadPool::~ThreadPool() {
+	stopWorkers();
+}
+
+void ThreadPool::setWorkerCount(unsigned int workerCount) {
+	std::lock_guard<std::mutex> dispatchLock(mDispatchMutex);
+	stopWorkers();
+	startWorkers(workerCount);
+}
+
+unsigned int ThreadPool::getWorkerCount() const {
+	return (unsigned int)mWorkers.size() + 1;
+}
+
+void ThreadPool::parallelFor(std::size_t taskCount, const task_t& task) {
+	std::lock_guard<std::mutex> dispatchLock(mDispatchMutex);
+	if (mWorkers.empty() || taskCount <= 1) {
+		for (std::size_t i = 0; i < taskCount; i++)
+			task(i);
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mTask = &task;
+		mTaskCount = taskCount;
+		mNextTask = 0;
+		mPendingWorkers = mWorkers.size();
+		mGeneration++;
+	}
+	mWorkAvailable.notify_all();
+	runTasks();
+	std::unique_lock<std::mutex> lock(mMutex);
+	mWorkFinished.wait(lock, [this]() { return mPendingWorkers == 0; });
+	mTask = nullptr;
+}
+
+void ThreadPool::startWorkers(unsigned int workerCount) {
+	if (workerCount == 0)
+		workerCount = std::max(1u, std::thread::hardware_concurrency());
+	// The generation is read here rather than by each worker once it runs, so a parallelFor dispatched before a worker
+	// thread gets scheduled is still seen as new work
+	std::size_t generation;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mIsStopping = false;
+		generation = mGeneration;
+	}
+	for (unsigned int i = 1; i < workerCount; i++)
+		mWorkers.emplace_back(&ThreadPool::workerLoop, this, generation);
+}
+
+void ThreadPool::stopWorkers() {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mIsStopping = true;
+	}
+	mWorkAvailable.notify_all();
+	for (auto& worker : mWorkers)
+		worker.join();
+	mWorkers.clear();
+}
+
+void ThreadPool::workerLoop(std::size_t seenGeneration) {
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mWorkAvailable.wait(lock, [this, seenGeneration]() { return mIsStopping || mGeneration != seenGeneration; });
+			if (mIsStopping) return;
+			seenGeneration = mGeneration;
+		}
+		runTasks();
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (--mPendingWorkers == 0)
+			mWorkFinished.notify_one();
+	}
+}
+
+void ThreadPool::runTasks() {
+	for (std::size_t i = mNextTask++; i < mTaskCount; i = mNextTask++)
+		(*mTask)(i);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fork-join pool: parallelFor hands out task indices from a shared counter to the workers and the calling thread,
+// then blocks until every index has been run
+class ThreadPool {
+public:
+	typedef std::function<void(std::size_t)> task_t;
+
+	explicit ThreadPool(unsigned int workerCount = 0);
+	~ThreadPool();
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	void setWorkerCount(unsigned int workerCount);
+	unsigned int getWorkerCount() const;
+
+	void parallelFor(std::size_t taskCount, const task_t& task);
+private:
+	void startWorkers(unsigned int workerCount);
+	void stopWorkers();
+
+	void workerLoop(std::size_t seenGeneration);
+	void runTasks();
+
+	std::vector<std::thread> mWorkers;
+
+	std::mutex mDispatchMutex;
+	std::mutex mMutex;
+	std::condition_variable mWorkAvailable;
+	std::condition_variable mWorkFinished;
+
+	const task_t* mTask = nullptr;
+	std::size_t mTaskCount = 0;
+	std::atomic<std::size_t> mNextTask = 0;
+	std::size_t mGeneration = 0;
+	std::size_t mPendingWorkers = 0;
+	bool mIsStopping = false;
+};
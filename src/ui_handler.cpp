@@ -14,7 +14,7 @@ std::string UIHandler::ActionData::getPrompt() const {
 }
 
 UIHandler::UIHandler() :
-mMenuStack(), mCurrentPolynomials(), mCurrentSequences(), mFileHandler() {
+mMenuStack(), mCurrentPolynomials(), mCurrentSequences(), mFileHandler(), mThreadPool() {
 	pushToMenuStack(ROOT_MENU);
 }
 
@@ -115,3 +115,19 @@ void UIHandler::printFilenames(std::vector<std::string> filenames) const {
 		std::cout << " >\n";
 	}
 }
+
+// Overwrites in the requested format, or appends in the format the file already has. Binary sequences are never
+// appended to a text file, where they would quietly be written as text
+std::pair<int, std::string> UIHandler::saveSequences(std::string filename, bool append, FileHandler::SequenceFormat format) {
+	if (append) {
+		FileHandler::SequenceFormat existing;
+		if (!mFileHandler.getSequenceFileFormat(filename, existing))
+			return std::make_pair(0, "[Error] " + mFileHandler.getError() + "\n");
+		if (format != FileHandler::Text && existing == FileHandler::Text)
+			return std::make_pair(0, "[Error] '" + filename + "' is a text file, overwrite it or choose a new name to save as binary\n");
+		format = existing;
+	}
+	if (!(append ? mFileHandler.appendSequences(filename, mCurrentSequences) : mFileHandler.writeSequences(filename, mCurrentSequences, format)))
+		return std::make_pair(0, "[Error] " + mFileHandler.getError() + "\n");
+	return std::make_pair(1, "Successfully saved sequence to '" + filename + "' as " + SEQUENCE_FORMAT_NAMES.at(format) + "\n");
+}
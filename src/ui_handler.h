@@ -10,9 +10,14 @@
 #include <string>
 #include <vector>
 
+#include "batch.h"
+#include "derivation_cache.h"
 #include "file_handle.h"
 #include "polynomial.h"
+#include "sequence_set.h"
+#include "thread_pool.h"
 #include "utils.h"
+#include "vandermonde_cache.h"
 
 const std::string USER_INPUT_PROMPT = ">> ";
 const std::string HELP_MESSAGE_SEPARATOR = " -- ";
@@ -73,6 +78,13 @@ private:
 	void parseDataInput(std::string data);
 
 	void printFilenames(std::vector<std::string> filenames) const;
+	std::pair<int, std::string> saveSequences(std::string filename, bool append, FileHandler::SequenceFormat format);
+
+	const std::map<FileHandler::SequenceFormat, std::string> SEQUENCE_FORMAT_NAMES = {
+		{FileHandler::Text, "text"},
+		{FileHandler::Binary, "binary"},
+		{FileHandler::DeltaVarint, "delta varint binary"},
+	};
 
 	const MenuContent ROOT_MENU = {
 		[this]() {
@@ -98,14 +110,28 @@ private:
 				if (mCurrentSequences.empty()) {
 					std::cout << "Must load one or more sequences to derive from\n";
 				} else {
+					Algebra::Batch::DeriveResults results = Algebra::Batch::deriveAll(mThreadPool, mCurrentSequences);
 					mCurrentPolynomials.clear();
-					for (auto& sequence : mCurrentSequences) {
-						if (!mCurrentPolynomials.emplace_back().deriveFrom(sequence))
-							mCurrentPolynomials.pop_back();
-					}
-					std::cout << "Successfully derived " << mCurrentPolynomials.size() << "/" << mCurrentSequences.size() << " sequences\n";
+					mCurrentPolynomials.reserve(results.derivedCount);
+					for (std::size_t i = 0; i < results.polynomials.size(); i++)
+						if (results.isDerived[i])
+							mCurrentPolynomials.push_back(std::move(results.polynomials[i]));
+					std::cout << "Successfully derived " << mCurrentPolynomials.size() << "/" << mCurrentSequences.size() << " sequences ("
+						<< results.uniqueCount << " searched, " << mCurrentSequences.size() - results.uniqueCount << " duplicates skipped, "
+						<< results.candidateCount << " candidates examined, " << results.cacheHits << " cached)\n";
 				}
 			}, "Derive polynomials from the currently loaded sequences"},
+			{"stats", [this]() {
+				Algebra::VandermondeCache::Statistics stats = Algebra::VandermondeCache::instance().getStatistics();
+				std::size_t lookups = stats.hits + stats.misses;
+				std::cout << "Vandermonde cache: " << stats.entries << " entries (" << stats.bytes / 1024 << " KiB), "
+					<< stats.hits << "/" << lookups << " hits (" << (lookups == 0 ? 0 : 100 * stats.hits / lookups) << "%)\n";
+				Algebra::DerivationCache::Statistics derivations = Algebra::DerivationCache::instance().getStatistics();
+				lookups = derivations.hits + derivations.misses;
+				std::cout << "Derivation cache: " << derivations.entries << "/" << derivations.capacity << " entries, "
+					<< derivations.evictions << " evictions, " << derivations.hits << "/" << lookups << " hits ("
+					<< (lookups == 0 ? 0 : 100 * derivations.hits / lookups) << "%)\n";
+			}, "Show derivation cache statistics"},
 			{"list", [this]() {
 				std::vector<std::string> polynomials;
 				std::vector<std::string> sequences;
@@ -116,6 +142,7 @@ private:
 				std::cout << "Polynomials: <" << Utils::join(polynomials) << ">\n";
 				std::cout << "Sequences: <" << Utils::join(sequences) << ">\n";
 			}, "List all available polynomial and sequence files"},
+			{"workers", [this]() { pushToMenuStack(WORKERS_MENU); }, "Set how many threads batch operations use"},
 			{"save", [this]() { pushToMenuStack(SAVE_MENU); }, "Save current polynomial/sequence to a file"},
 			{"load", [this]() { pushToMenuStack(LOAD_MENU); }, "Load polynomial/sequence from a file"},
 			{"quit", [this]() { stopLoop(); }, ""},
@@ -197,8 +224,10 @@ private:
 						int& count = std::any_cast<int&>(getCurrentMenuData("count"));
 						int& sequenceStart = std::any_cast<int&>(getCurrentMenuData("sequenceStart"));
 						int& sequenceEnd = std::any_cast<int&>(getCurrentMenuData("sequenceEnd"));
+						Algebra::Sequence sequence;
+						sequence.generateFrom(sequenceStart, sequenceEnd, sequenceStep);
 						for (int i = 0; i < count; i++)
-							mCurrentSequences.emplace_back().generateFrom(sequenceStart, sequenceEnd, sequenceStep);
+							mCurrentSequences.pushBack(sequence.elements);
 						return std::make_pair(1, std::string());
 					}
 					return std::make_pair(0, std::string("[Error] Expected an integer\n"));
@@ -251,7 +280,7 @@ private:
 					if (std::optional<int> parsedInput = castUserInputInt(input); parsedInput.has_value()) {
 						if (parsedInput < 0 || parsedInput >= mCurrentSequences.size())
 							return std::make_pair(0, "[Error] Value out of range\n");
-						mCurrentSequences.erase(mCurrentSequences.begin() + parsedInput.value());
+						mCurrentSequences.erase(parsedInput.value());
 						return std::make_pair(1, "Successfuly deleted sequence\n");
 					}
 					return std::make_pair(0, "[Error] Expected an integer\n");
@@ -301,7 +330,7 @@ private:
 						if (parsedInput.value() < 0 || parsedInput.value() >= mCurrentSequences.size())
 							return std::make_pair(0, "[Error] Value out of range\n");
 						int& polyIndex = std::any_cast<int&>(getCurrentMenuData("polynomial"));
-						mCurrentPolynomials[polyIndex].apply(mCurrentSequences[parsedInput.value()]);
+						mCurrentPolynomials[polyIndex].apply(mCurrentSequences.getElements(parsedInput.value()));
 						return std::make_pair(1, "Successfully applied polynomial to sequence\n");
 					}
 					return std::make_pair(0, "[Error] Expected an integer\n");
@@ -322,10 +351,9 @@ private:
 				[this]() { return "Which polynomial will you use?\n"; },
 				[this](std::string input) {
 					if (std::optional<int> parsedInput = castUserInputInt(input); parsedInput.has_value()) {
-						if (parsedInput.value() < 0 || parsedInput.value() > mCurrentPolynomials.size())
+						if (parsedInput.value() < 0 || parsedInput.value() >= mCurrentPolynomials.size())
 							return std::make_pair(0, std::string("[Error] Value out of range\n"));
-						for (auto& sequence : mCurrentSequences)
-							mCurrentPolynomials[parsedInput.value()].apply(sequence);
+						Algebra::Batch::applyAll(mThreadPool, mCurrentPolynomials[parsedInput.value()], mCurrentSequences);
 						return std::make_pair(1, "Successfully applied polynomial (" + mCurrentPolynomials[parsedInput.value()].toString() + ") to sequences\n");
 					}
 					return std::make_pair(0, std::string("[Error] Expected an integer\n"));
@@ -333,11 +361,32 @@ private:
 			}
 		}
 	};
+	const MenuContent WORKERS_MENU = {
+		[this]() { return "Currently using " + std::to_string(mThreadPool.getWorkerCount()) + " worker thread(s)\n"; },
+		{
+			{"back", [this]() { softPopMenu(); }, ""},
+		},
+		{
+			{
+				[this]() { return "How many worker threads should be used? (0 for one per core)\n"; },
+				[this](std::string input) {
+					if (std::optional<int> parsedInput = castUserInputInt(input); parsedInput.has_value()) {
+						if (parsedInput.value() < 0)
+							return std::make_pair(0, std::string("[Error] Value out of range\n"));
+						mThreadPool.setWorkerCount(parsedInput.value());
+						return std::make_pair(1, "Now using " + std::to_string(mThreadPool.getWorkerCount()) + " worker thread(s)\n");
+					}
+					return std::make_pair(0, std::string("[Error] Expected an integer\n"));
+				}
+			}
+		}
+	};
 	const MenuContent SAVE_MENU = {
 		[this]() { return "Save...\n";  },
 		{
 			{"polynomial", [this]() { pushToMenuStack(SAVE_POLYNOMIAL_MENU); }, "Save current polynomial to a file"},
 			{"sequence", [this]() { pushToMenuStack(SAVE_SEQUENCE_MENU); }, "Save current sequence to a file"},
+			{"binary", [this]() { pushToMenuStack(SAVE_BINARY_SEQUENCE_MENU); }, "Save current sequence to a compact binary file"},
 			{"back", [this]() { softPopMenu(); }, ""},
 		}
 	};
@@ -378,11 +427,30 @@ private:
 						if (std::string action = requestUserInput(); action != "a" && action != "o")
 							return std::make_pair(0, std::string(""));
 						else
-							return ((action == "a") ? mFileHandler.appendSequences(input, mCurrentSequences) : mFileHandler.writeSequences(input, mCurrentSequences)) ?
-							std::make_pair(1, "Successfully saved sequence to '" + input + "'\n") : std::make_pair(0, "[Error] " + mFileHandler.getError() + "\n");
-					} else if (mFileHandler.writeSequences(input, mCurrentSequences)) {
-						return std::make_pair(1, "Successfully saved sequence to '" + input + "'\n");
+							return saveSequences(input, action == "a", FileHandler::Text);
+					}
+					return saveSequences(input, false, FileHandler::Text);
+				}
+			}
+		}
+	};
+	const MenuContent SAVE_BINARY_SEQUENCE_MENU = {
+		[this]() { return "Save sequence as binary...\n";  },
+		{
+			{"back", [this]() { softPopMenu(); }, ""},
+		},
+		{
+			{
+				[this]() { return "What do you want to call the file?\n"; },
+				[this](std::string input) {
+					if (mFileHandler.sequenceFileExists(input)) {
+						std::cout << "File already exists\n(a | append, o | overwrite, n | new name)\n";
+						if (std::string action = requestUserInput(); action != "a" && action != "o")
+							return std::make_pair(0, std::string(""));
+						else
+							return saveSequences(input, action == "a", FileHandler::Binary);
 					}
+					return saveSequences(input, false, FileHandler::Binary);
 				}
 			}
 		}
@@ -406,7 +474,7 @@ private:
 				[this](std::string input) {
 					if (mFileHandler.expressionFileExists(input)) {
 						mCurrentPolynomials.clear();
-						if (mFileHandler.readExpressions(input, mCurrentPolynomials)) {
+						if (mFileHandler.readExpressions(input, mCurrentPolynomials, mThreadPool)) {
 							return std::make_pair(1, std::string("Successfully read polynomials from file\n"));
 						} else {
 							return std::make_pair(0, "[Error] " + mFileHandler.getError() + "\n");
@@ -428,7 +496,7 @@ private:
 				[this](std::string input) {
 					if (mFileHandler.sequenceFileExists(input)) {
 						mCurrentSequences.clear();
-						if (mFileHandler.readSequences(input, mCurrentSequences)) {
+						if (mFileHandler.readSequences(input, mCurrentSequences, mThreadPool)) {
 							return std::make_pair(1, std::string("Successfully read sequences from file\n"));
 						} else {
 							return std::make_pair(0, "[Error] " + mFileHandler.getError() + "\n");
@@ -444,7 +512,8 @@ private:
 
 	bool mIsRunning = false;
 	std::vector<Algebra::Polynomial> mCurrentPolynomials;
-	std::vector<Algebra::Sequence> mCurrentSequences;
+	Algebra::SequenceSet mCurrentSequences;
 
 	FileHandler mFileHandler;
+	ThreadPool mThreadPool;
 };
@@ -0,0 +1,68 @@
+#include "vandermonde_cache.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+namespace Algebra {
+	VandermondeCache& VandermondeCache::instance() {
+		static VandermondeCache cache;
+		return cache;
+	}
+
+	VandermondeCache::VandermondeCache() : mMutex(), mInverses() {
+
+	}
+
+	const Matrix<Rational>* VandermondeCache::getInverse(int degree, int offset, int step, Matrix<Rational>& scratch) {
+		long long key = makeKey(degree, offset, step);
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (auto found = mInverses.find(key); found != mInverses.end()) {
+				mHits++;
+				return &found->second;
+			}
+			mMisses++;
+		}
+		if (!computeInverse(degree, offset, step, scratch))
+			return nullptr;
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mInverses.size() >= MAX_ENTRIES)
+			return &scratch;
+		auto [entry, inserted] = mInverses.emplace(key, std::move(scratch));
+		if (inserted)
+			mBytes += sizeof(*entry) + sizeof(void*) + entry->second.matrix.capacity() * sizeof(Rational) + entry->second.permutation.capacity() * sizeof(int);
+		return &entry->second;
+	}
+
+	VandermondeCache::Statistics VandermondeCache::getStatistics() {
+		std::lock_guard<std::mutex> lock(mMutex);
+		return { mHits, mMisses, mInverses.size(), mBytes + mInverses.bucket_count() * sizeof(void*) };
+	}
+
+	void VandermondeCache::clear() {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mInverses.clear();
+		mHits = mMisses = mBytes = 0;
+	}
+
+	long long VandermondeCache::makeKey(int degree, int offset, int step) const {
+		return ((long long)degree << 48) | ((long long)(offset & 0xFFFFFF) << 24) | (long long)(step & 0xFFFFFF);
+	}
+
+	bool VandermondeCache::computeInverse(int degree, int offset, int step, Matrix<Rational>& inverse) const {
+		Matrix<Rational> vandermonde(degree + 1);
+		for (int i = 0; i < degree + 1; i++) {
+			long long x = offset + (long long)i * step, term = 1;
+			for (int exp = 0; exp < degree + 1; exp++) {
+				vandermonde(i, exp) = term;
+				if (exp < degree && x != 0 && std::llabs(term) > LLONG_MAX / std::llabs(x))
+					return false;
+				term *= x;
+			}
+		}
+		if (!vandermonde.decompose() || !vandermonde.getInverse(inverse))
+			return false;
+		return std::all_of(inverse.matrix.begin(), inverse.matrix.end(), [](const Rational& value) { return value.isValid(); });
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+
+#include "matrix.h"
+#include "rational.h"
+
+namespace Algebra {
+	// Process-wide cache of inverted Vandermonde systems with nodes x[i] = offset + i * step.
+	// Cached inverses stay valid until clear() is called; once full, inverses are built into the caller's scratch matrix
+	class VandermondeCache {
+	public:
+		struct Statistics {
+			std::size_t hits;
+			std::size_t misses;
+			std::size_t entries;
+			std::size_t bytes;
+		};
+
+		static VandermondeCache& instance();
+
+		const Matrix<Rational>* getInverse(int degree, int offset, int step, Matrix<Rational>& scratch);
+
+		Statistics getStatistics();
+		void clear();
+	private:
+		VandermondeCache();
+
+		long long makeKey(int degree, int offset, int step) const;
+		bool computeInverse(int degree, int offset, int step, Matrix<Rational>& inverse) const;
+
+		const std::size_t MAX_ENTRIES = 1 << 17;
+
+		std::mutex mMutex;
+		std::unordered_map<long long, Matrix<Rational>> mInverses;
+		std::size_t mHits = 0;
+		std::size_t mMisses = 0;
+		std::size_t mBytes = 0;
+	};
+}
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "file_handle.h"
+#include "sequence_set.h"
+#include "thread_pool.h"
+
+static const std::streamoff SEQUENCE_COUNT_OFFSET = 8;
+static const std::streamoff ELEMENT_COUNT_OFFSET = 16;
+static const std::streamoff OFFSETS_OFFSET = 32;
+
+static Algebra::SequenceSet makeSequences() {
+	Algebra::SequenceSet sequences;
+	sequences.pushBack(std::vector<int>{ 1, 2, 3, 4 });
+	sequences.pushBack(std::vector<int>{});
+	sequences.pushBack(std::vector<int>{ -7, 0, 7, 1000000, -1000000 });
+	sequences.pushBack(std::vector<int>{ INT_MAX, INT_MIN, INT_MAX, 0 });
+	return sequences;
+}
+
+static bool isEqual(const Algebra::SequenceSet& a, const Algebra::SequenceSet& b) {
+	if (a.size() != b.size())
+		return false;
+	for (std::size_t i = 0; i < a.size(); i++) {
+		std::span<const int> x = a[i].elements, y = b[i].elements;
+		if (!std::equal(x.begin(), x.end(), y.begin(), y.end()))
+			return false;
+	}
+	return true;
+}
+
+static bool writeFile(FileHandler& fileHandler, const std::string& path, const Algebra::SequenceSet& sequences, FileHandler::SequenceFormat format) {
+	std::ofstream file(path, std::ios::binary);
+	return fileHandler.writeSequenceStream(file, sequences, format);
+}
+
+static std::uint64_t readUint64(std::fstream& file, std::streamoff position) {
+	unsigned char bytes[8];
+	file.seekg(position);
+	file.read((char*)bytes, sizeof(bytes));
+	std::uint64_t value = 0;
+	for (int byte = 7; byte >= 0; byte--)
+		value = (value << 8) | bytes[byte];
+	return value;
+}
+
+static void writeUint64(std::fstream& file, std::streamoff position, std::uint64_t value) {
+	file.seekp(position);
+	for (int byte = 0; byte < 8; byte++)
+		file.put((char)(value >> (byte * 8)));
+}
+
+// Overwrites the element count and the final offset together, so the header stays self-consistent the way a crafted
+// file would and only the bounds against the column size can reject it
+static void patchElementCount(const std::string& path, std::uint64_t elementCount) {
+	std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+	std::uint64_t sequenceCount = readUint64(file, SEQUENCE_COUNT_OFFSET);
+	writeUint64(file, ELEMENT_COUNT_OFFSET, elementCount);
+	writeUint64(file, OFFSETS_OFFSET + (std::streamoff)(sequenceCount * sizeof(std::uint64_t)), elementCount);
+}
+
+static bool checkRoundTrip(FileHandler& fileHandler, ThreadPool& pool, const std::string& path, FileHandler::SequenceFormat format, const char* name) {
+	Algebra::SequenceSet written = makeSequences(), read;
+	if (!writeFile(fileHandler, path, written, format) || !fileHandler.readSequenceFile(path, read, pool)) {
+		std::cerr << name << ": round trip failed: " << fileHandler.getError() << "\n";
+		return false;
+	}
+	if (!isEqual(written, read)) {
+		std::cerr << name << ": sequences read back differ from those written\n";
+		return false;
+	}
+	return true;
+}
+
+static bool checkCorruptHeader(FileHandler& fileHandler, ThreadPool& pool, const std::string& path, const Algebra::SequenceSet& sequences,
+	FileHandler::SequenceFormat format, std::uint64_t elementCount, const char* name) {
+	if (!writeFile(fileHandler, path, sequences, format)) {
+		std::cerr << name << ": could not write the file to corrupt\n";
+		return false;
+	}
+	patchElementCount(path, elementCount);
+	Algebra::SequenceSet read;
+	if (fileHandler.readSequenceFile(path, read, pool)) {
+		std::cerr << name << ": corrupt header was accepted\n";
+		return false;
+	}
+	if (fileHandler.getError().find("malformed") == std::string::npos || !read.empty()) {
+		std::cerr << name << ": expected a malformed sequence error and no sequences, got \"" << fileHandler.getError() << "\"\n";
+		return false;
+	}
+	return true;
+}
+
+// Appending rewrites a binary file through a temporary beside it, which must be renamed over the original and not left behind
+static bool checkAppend(FileHandler& fileHandler, ThreadPool& pool, FileHandler::SequenceFormat format, const char* name) {
+	Algebra::SequenceSet first = makeSequences(), second, expected, read;
+	second.pushBack(std::vector<int>{ 9, 8, 7 });
+	expected.append(first);
+	expected.append(second);
+	if (!fileHandler.writeSequences("appended", first, format) || !fileHandler.appendSequences("appended", second)
+		|| !fileHandler.readSequences("appended", read, pool)) {
+		std::cerr << name << ": append failed: " << fileHandler.getError() << "\n";
+		return false;
+	}
+	if (!isEqual(expected, read)) {
+		std::cerr << name << ": appended file differs from the merged sequences\n";
+		return false;
+	}
+	if (std::filesystem::exists("resources/sequences/appended.bsequence.tmp")) {
+		std::cerr << name << ": temporary file was left behind\n";
+		return false;
+	}
+	return true;
+}
+
+// The stored format is what the save menus report, and what decides whether a binary append is allowed
+static bool checkFormats(FileHandler& fileHandler) {
+	const FileHandler::SequenceFormat formats[3] = { FileHandler::Text, FileHandler::Binary, FileHandler::DeltaVarint };
+	for (FileHandler::SequenceFormat written : formats) {
+		FileHandler::SequenceFormat format;
+		if (!fileHandler.writeSequences("formats", makeSequences(), written) || !fileHandler.getSequenceFileFormat("formats", format)) {
+			std::cerr << "format: could not write or inspect the file: " << fileHandler.getError() << "\n";
+			return false;
+		}
+		if (format != written) {
+			std::cerr << "format: wrote format " << written << ", read back " << format << "\n";
+			return false;
+		}
+	}
+	return true;
+}
+
+int main() {
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "binary_sequence_test";
+	std::filesystem::create_directories(directory / "resources" / "sequences");
+	std::filesystem::current_path(directory);
+	std::string path = (directory / "direct.bsequence").string();
+	FileHandler fileHandler;
+	ThreadPool pool(2);
+	// One raw element is a four byte column, which the wrapped product 0x4000000000000001 * 4 also matches
+	Algebra::SequenceSet single;
+	single.pushBack(std::vector<int>{ 5 });
+	bool success = checkRoundTrip(fileHandler, pool, path, FileHandler::Binary, "raw")
+		&& checkRoundTrip(fileHandler, pool, path, FileHandler::DeltaVarint, "delta varint")
+		&& checkAppend(fileHandler, pool, FileHandler::Binary, "raw append")
+		&& checkAppend(fileHandler, pool, FileHandler::DeltaVarint, "delta varint append")
+		&& checkFormats(fileHandler)
+		&& checkCorruptHeader(fileHandler, pool, path, makeSequences(), FileHandler::DeltaVarint, 0x10000000000ull, "delta varint element count")
+		&& checkCorruptHeader(fileHandler, pool, path, single, FileHandler::Binary, 0x4000000000000001ull, "raw element count");
+	std::error_code error;
+	std::filesystem::current_path(directory.parent_path(), error);
+	std::filesystem::remove_all(directory, error);
+	if (!success)
+		return 1;
+	std::cout << "Binary sequences: round trip, append, format and corrupt header checks passed\n";
+	return 0;
+}
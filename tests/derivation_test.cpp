@@ -0,0 +1,328 @@
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "batch.h"
+#include "derivation_cache.h"
+#include "file_handle.h"
+#include "polynomial.h"
+#include "sequence_set.h"
+#include "thread_pool.h"
+
+static bool checkDerives(const std::vector<int>& elements, const std::string& expected) {
+	Algebra::Polynomial polynomial;
+	if (!polynomial.deriveFrom(Algebra::Sequence(elements)) || polynomial.toString() != expected) {
+		std::cerr << "expected \"" << expected << "\", got \"" << polynomial.toString() << "\"\n";
+		return false;
+	}
+	return true;
+}
+
+// getDegree writes the leading difference of each row and stops at the first constant row, leaving the rest of the
+// span untouched; a span too short to reach a constant row reports INT_MAX
+static bool checkDifferences() {
+	Algebra::Sequence squares({ 1, 4, 9, 16, 25 });
+	long long differences[Algebra::Limits::MAX_EXPONENT + 1] = { -1, -1, -1, -1, -1 };
+	const long long expected[Algebra::Limits::MAX_EXPONENT + 1] = { 1, 3, 2, -1, -1 };
+	int degree = squares.getDegree(differences);
+	if (degree != 2 || !std::equal(differences, differences + Algebra::Limits::MAX_EXPONENT + 1, expected)) {
+		std::cerr << "differences: 1,4,9,16,25 gave degree " << degree << " and leading differences " << differences[0] << ","
+			<< differences[1] << "," << differences[2] << "," << differences[3] << "," << differences[4] << "\n";
+		return false;
+	}
+	long long capped[2];
+	if (squares.getDegree(capped) != INT_MAX || squares.getDegree() != 2 || Algebra::Sequence({ 7, 7, 7 }).getDegree() != 0) {
+		std::cerr << "differences: degree was not capped by the span or misread for a constant sequence\n";
+		return false;
+	}
+	return true;
+}
+
+// A failed derivation must not leave the previous result loaded, whichever check rejects the sequence
+static bool checkFailureClears(const std::vector<int>& elements, const char* name) {
+	Algebra::Polynomial polynomial;
+	if (!polynomial.deriveFrom(Algebra::Sequence({ 1, 2, 3 }))) {
+		std::cerr << name << ": could not derive the initial polynomial\n";
+		return false;
+	}
+	if (polynomial.deriveFrom(Algebra::Sequence(elements))) {
+		std::cerr << name << ": derivation unexpectedly succeeded\n";
+		return false;
+	}
+	if (polynomial.isLoaded() || polynomial.toString() != "") {
+		std::cerr << name << ": previous result \"" << polynomial.toString() << "\" was left in place\n";
+		return false;
+	}
+	return true;
+}
+
+// Searches the same (step, offset) space as deriveFrom for any placement at which the polynomial reproduces the elements
+static bool fitsSequence(const Algebra::Polynomial& polynomial, const std::vector<int>& elements) {
+	for (int step = 1; step < 20; step++) {
+		for (int offset = -500; offset <= 500; offset++) {
+			std::size_t k = 0;
+			for (; k < elements.size(); k++) {
+				long long x = offset + (long long)k * step, value = 0;
+				for (int exp = Algebra::Limits::MAX_EXPONENT; exp >= 0; exp--)
+					value = value * x + polynomial.getCoefficient(exp);
+				if (value != elements[k])
+					break;
+			}
+			if (k == elements.size())
+				return true;
+		}
+	}
+	return false;
+}
+
+// Samples polynomials within the coefficient limits at a random offset and step, so a fit always exists
+static std::vector<std::vector<int>> makeFittableSequences(std::size_t count) {
+	std::mt19937 random(8501);
+	std::uniform_int_distribution<int> coefficient(-Algebra::Limits::MAX_COEFFICIENT, Algebra::Limits::MAX_COEFFICIENT);
+	std::uniform_int_distribution<int> constant(-Algebra::Limits::MAX_CONSTANT, Algebra::Limits::MAX_CONSTANT);
+	std::uniform_int_distribution<int> degree(0, Algebra::Limits::MAX_EXPONENT), offset(-20, 20), step(1, 5);
+	std::vector<std::vector<int>> sequences;
+	while (sequences.size() < count) {
+		long long coeffs[Algebra::Limits::MAX_EXPONENT + 1]{};
+		int d = degree(random);
+		coeffs[0] = constant(random);
+		for (int exp = 1; exp <= d; exp++)
+			coeffs[exp] = coefficient(random);
+		if (d > 0 && coeffs[d] == 0)
+			continue;
+		int first = offset(random), gap = step(random);
+		std::vector<int> elements;
+		for (int k = 0; k < 8; k++) {
+			long long x = first + (long long)k * gap, value = 0;
+			for (int exp = d; exp >= 0; exp--)
+				value = value * x + coeffs[exp];
+			elements.push_back((int)value);
+		}
+		sequences.push_back(std::move(elements));
+	}
+	return sequences;
+}
+
+// Every strategy must find a genuine fit; Analytic only prunes candidates that cannot fit, so it must agree with
+// Exhaustive exactly while examining fewer candidates
+static bool checkStrategies() {
+	std::size_t exhaustiveCandidates = 0, analyticCandidates = 0;
+	for (const auto& elements : makeFittableSequences(40)) {
+		Algebra::Sequence sequence(elements);
+		Algebra::Polynomial polynomials[3];
+		const Algebra::SearchStrategy strategies[3] = { Algebra::Exhaustive, Algebra::NearestFirst, Algebra::Analytic };
+		const char* names[3] = { "exhaustive", "nearest first", "analytic" };
+		for (int s = 0; s < 3; s++) {
+			Algebra::SearchStatistics statistics;
+			if (!polynomials[s].deriveFrom(sequence, strategies[s], statistics) || !fitsSequence(polynomials[s], elements)) {
+				std::cerr << names[s] << ": no valid fit for " << sequence.toString() << ", got \"" << polynomials[s].toString() << "\"\n";
+				return false;
+			}
+			if (strategies[s] == Algebra::Exhaustive)
+				exhaustiveCandidates += statistics.candidatesExamined;
+			else if (strategies[s] == Algebra::Analytic)
+				analyticCandidates += statistics.candidatesExamined;
+		}
+		if (polynomials[2].toString() != polynomials[0].toString()) {
+			std::cerr << "analytic: \"" << polynomials[2].toString() << "\" differs from exhaustive \"" << polynomials[0].toString()
+				<< "\" for " << sequence.toString() << "\n";
+			return false;
+		}
+	}
+	if (analyticCandidates >= exhaustiveCandidates) {
+		std::cerr << "analytic: examined " << analyticCandidates << " candidates, exhaustive " << exhaustiveCandidates << "\n";
+		return false;
+	}
+	return true;
+}
+
+// Deduplicated derivation must give every sequence the result it would get on its own, while searching once per
+// group. 1,2,3 and 1,2,3,4,5 share a normal form, and so do every sequence that cannot be derived
+static bool checkDeduplication(ThreadPool& pool) {
+	Algebra::DerivationCache::instance().setCapacity(0);
+	Algebra::SequenceSet sequences;
+	std::vector<std::vector<int>> fittable = makeFittableSequences(10);
+	for (int copy = 0; copy < 3; copy++) {
+		for (const auto& elements : fittable)
+			sequences.pushBack(elements);
+		sequences.pushBack(std::vector<int>{ 1, 2, 3 });
+		sequences.pushBack(std::vector<int>{ 1, 2, 3, 4, 5 });
+		sequences.pushBack(std::vector<int>{ 1, 2 });
+		sequences.pushBack(std::vector<int>{ 1, 2, 4, 8, 16, 32, 64, 128 });
+	}
+	Algebra::Batch::DeriveResults separate = Algebra::Batch::deriveAll(pool, sequences, Algebra::Analytic, false);
+	Algebra::Batch::DeriveResults grouped = Algebra::Batch::deriveAll(pool, sequences, Algebra::Analytic, true);
+	for (std::size_t i = 0; i < sequences.size(); i++) {
+		if (grouped.isDerived[i] != separate.isDerived[i] || grouped.polynomials[i].toString() != separate.polynomials[i].toString()) {
+			std::cerr << "deduplication: sequence " << i << " got \"" << grouped.polynomials[i].toString() << "\", alone \""
+				<< separate.polynomials[i].toString() << "\"\n";
+			return false;
+		}
+	}
+	Algebra::Batch::Groups groups = Algebra::Batch::groupForDerivation(pool, sequences);
+	std::size_t groupCount = groups.representatives.size();
+	if (separate.uniqueCount != sequences.size() || grouped.uniqueCount != groupCount || groupCount > fittable.size() + 2) {
+		std::cerr << "deduplication: searched " << grouped.uniqueCount << " of " << sequences.size() << " sequences\n";
+		return false;
+	}
+	std::size_t base = fittable.size();
+	if (groups.groupOf[base] != groups.groupOf[base + 1] || groups.groupOf[base + 2] != groups.groupOf[base + 3]
+		|| groups.groupOf[base] == groups.groupOf[base + 2]) {
+		std::cerr << "deduplication: equivalent sequences were not grouped together\n";
+		return false;
+	}
+	return true;
+}
+
+// Limits::MAX_SUPPORTED_EXPONENT is the highest degree a sequence of ints can reach, x^12 - 9x^10 at -6..6 among them.
+// Fits that deep must come out exact from every strategy, not just within range
+static bool checkHighDegree() {
+	const int DEGREES = Algebra::Limits::MAX_SUPPORTED_EXPONENT + 1;
+	struct Case {
+		int first, last;
+		int coeffs[DEGREES];
+	};
+	const Case cases[2] = {
+		{ -5, 6, { 17, -5, 0, 0, 1, 0, 0, 0, 0, -2, 3 } },
+		{ -6, 6, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -9, 0, 1 } },
+	};
+	for (const Case& c : cases) {
+		std::vector<int> elements;
+		for (long long x = c.first; x <= c.last; x++) {
+			long long value = 0;
+			for (int exp = DEGREES - 1; exp >= 0; exp--)
+				value = value * x + c.coeffs[exp];
+			elements.push_back((int)value);
+		}
+		for (Algebra::SearchStrategy strategy : { Algebra::Exhaustive, Algebra::NearestFirst, Algebra::Analytic }) {
+			Algebra::BasicPolynomial<Algebra::Limits::MAX_SUPPORTED_EXPONENT> polynomial;
+			Algebra::SearchStatistics statistics;
+			bool isDerived = polynomial.deriveFrom(Algebra::Sequence(elements), strategy, statistics);
+			for (int exp = 0; exp < DEGREES && isDerived; exp++)
+				isDerived = polynomial.getCoefficient(exp) == c.coeffs[exp];
+			if (!isDerived) {
+				std::cerr << "high degree: strategy " << strategy << " derived \"" << polynomial.toString() << "\" from "
+					<< Algebra::Sequence(elements).toString() << " after " << statistics.candidatesExamined << " candidates\n";
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static bool findCached(const Algebra::Sequence& sequence, std::uint64_t fingerprint, Algebra::SearchStrategy strategy, std::string& text, bool& isDerived) {
+	Algebra::Polynomial polynomial;
+	bool isFound = Algebra::DerivationCache::instance().find(fingerprint, sequence, strategy, polynomial, isDerived);
+	text = polynomial.toString();
+	return isFound;
+}
+
+// Capacity 2 with three insertions evicts the least recently used entry, underivable results are cached as such, and an
+// entry stored under another sequence's fingerprint is never returned for that sequence
+static bool checkCache() {
+	Algebra::DerivationCache& cache = Algebra::DerivationCache::instance();
+	cache.clear();
+	cache.setCapacity(2);
+	const Algebra::Sequence linear({ 1, 2, 3 }), square({ 1, 4, 9, 16 }), underivable({ 1, 2, 4, 8, 16, 32, 64, 128 });
+	auto fingerprint = [](const Algebra::Sequence& sequence) { return Algebra::DerivationCache::getFingerprint(sequence, Algebra::Analytic); };
+	for (const Algebra::Sequence* sequence : { &linear, &square, &underivable }) {
+		Algebra::Polynomial polynomial;
+		bool isDerived = polynomial.deriveFrom(*sequence);
+		cache.insert(fingerprint(*sequence), *sequence, Algebra::Analytic, polynomial, isDerived);
+	}
+	std::string text;
+	bool isDerived = true;
+	if (findCached(linear, fingerprint(linear), Algebra::Analytic, text, isDerived)) {
+		std::cerr << "cache: the oldest entry was not evicted\n";
+		return false;
+	}
+	if (!findCached(underivable, fingerprint(underivable), Algebra::Analytic, text, isDerived) || isDerived || text != "") {
+		std::cerr << "cache: the underivable sequence came back as \"" << text << "\"\n";
+		return false;
+	}
+	if (!findCached(square, fingerprint(square), Algebra::Analytic, text, isDerived) || !isDerived || text != "x^2 + 2x + 1") {
+		std::cerr << "cache: the square sequence came back as \"" << text << "\"\n";
+		return false;
+	}
+	// The square was used last, so inserting again evicts the underivable entry
+	Algebra::Polynomial line;
+	line.deriveFrom(linear);
+	cache.insert(fingerprint(linear), linear, Algebra::Analytic, line, true);
+	if (findCached(underivable, fingerprint(underivable), Algebra::Analytic, text, isDerived) || !findCached(square, fingerprint(square), Algebra::Analytic, text, isDerived)) {
+		std::cerr << "cache: eviction did not follow the order of use\n";
+		return false;
+	}
+	// A colliding insertion replaces the entry; the fingerprint alone no longer finds the square
+	cache.insert(fingerprint(square), linear, Algebra::Analytic, line, true);
+	if (findCached(square, fingerprint(square), Algebra::Analytic, text, isDerived) || !findCached(linear, fingerprint(square), Algebra::Analytic, text, isDerived)
+		|| text != "x + 1" || findCached(linear, fingerprint(square), Algebra::Exhaustive, text, isDerived)) {
+		std::cerr << "cache: a colliding fingerprint returned another sequence's result\n";
+		return false;
+	}
+	Algebra::DerivationCache::Statistics statistics = cache.getStatistics();
+	if (statistics.hits != 4 || statistics.misses != 4 || statistics.evictions != 2 || statistics.entries != 2 || statistics.capacity != 2) {
+		std::cerr << "cache: counted " << statistics.hits << " hits, " << statistics.misses << " misses, " << statistics.evictions
+			<< " evictions and " << statistics.entries << " entries\n";
+		return false;
+	}
+	cache.clear();
+	cache.setCapacity(Algebra::DerivationCache::DEFAULT_CAPACITY);
+	return true;
+}
+
+// The zero polynomial is written as 0 and reads back, so an empty line in derive output only ever means no fit
+static bool checkZeroPolynomial() {
+	Algebra::Polynomial derived, parsed;
+	if (!derived.deriveFrom(Algebra::Sequence({ 0, 0, 0 })) || derived.toString() != "0") {
+		std::cerr << "zero polynomial: expected \"0\", got \"" << derived.toString() << "\"\n";
+		return false;
+	}
+	if (!parsed.parseFrom(derived.toString()) || parsed.toString() != "0") {
+		std::cerr << "zero polynomial: \"0\" did not read back: " << parsed.getError() << "\n";
+		return false;
+	}
+	return true;
+}
+
+// Mirrors the command line derive output: one line per sequence, empty only for sequences without a fit
+static bool checkDeriveOutput(ThreadPool& pool) {
+	Algebra::SequenceSet sequences;
+	sequences.pushBack(std::vector<int>{ 0, 0, 0 });
+	sequences.pushBack(std::vector<int>{ 1, 2, 4, 8, 16, 32, 64, 128 });
+	sequences.pushBack(std::vector<int>{ 1, 2, 3 });
+	Algebra::Batch::DeriveResults results = Algebra::Batch::deriveAll(pool, sequences);
+	std::ostringstream output;
+	FileHandler fileHandler;
+	if (!fileHandler.writeExpressionStream(output, results.polynomials) || output.str() != "0\n\nx + 1\n" || results.derivedCount != 2) {
+		std::cerr << "derive output: got \"" << output.str() << "\" with " << results.derivedCount << " derived\n";
+		return false;
+	}
+	return true;
+}
+
+int main() {
+	ThreadPool pool(2);
+	std::vector<int> sextic;
+	for (int x = 1; x <= 9; x++)
+		sextic.push_back(x * x * x * x * x * x);
+	bool success = checkDifferences()
+		&& checkDerives({ 1, 2, 3 }, "x + 1")
+		&& checkFailureClears({ 1, 2 }, "too short")
+		&& checkFailureClears(sextic, "degree too high")
+		&& checkFailureClears({ 1, 2, 4, 8, 16, 32, 64, 128 }, "no fit")
+		&& checkStrategies()
+		&& checkHighDegree()
+		&& checkCache()
+		&& checkZeroPolynomial()
+		&& checkDeriveOutput(pool)
+		&& checkDeduplication(pool);
+	if (!success)
+		return 1;
+	std::cout << "Derivation: all checks passed\n";
+	return 0;
+}
@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "apply_kernel.h"
+#include "polynomial.h"
+#include "polynomial_set.h"
+
+static const Algebra::Kernel::InstructionSet INSTRUCTION_SETS[3] = { Algebra::Kernel::Scalar, Algebra::Kernel::AVX2, Algebra::Kernel::AVX512 };
+
+// Lengths around the 8 and 16 lane widths, so every vector loop also runs its scalar tail
+static const std::size_t COUNTS[] = { 0, 1, 7, 8, 9, 15, 16, 17, 33, 1003 };
+
+// Wrapping 32-bit Horner evaluation, the arithmetic every kernel must reproduce
+static int evaluate(const int* coeffs, int degree, int x) {
+	std::uint32_t y = (std::uint32_t)coeffs[degree];
+	for (int exp = degree - 1; exp >= 0; exp--)
+		y = y * (std::uint32_t)x + (std::uint32_t)coeffs[exp];
+	return (int)y;
+}
+
+// Every instruction set at or below the one the CPU supports must give the scalar results, whatever the degree and
+// however far the values wrap
+static bool checkApplyHorner(std::mt19937& random) {
+	std::uniform_int_distribution<int> value(INT32_MIN, INT32_MAX);
+	for (int degree = 0; degree <= Algebra::Limits::MAX_SUPPORTED_EXPONENT; degree++) {
+		for (std::size_t count : COUNTS) {
+			std::vector<int> coeffs(degree + 1), elements(count);
+			for (int& c : coeffs)
+				c = value(random);
+			for (int& e : elements)
+				e = value(random);
+			for (Algebra::Kernel::InstructionSet instructionSet : INSTRUCTION_SETS) {
+				std::vector<int> results = elements;
+				Algebra::Kernel::applyHorner(coeffs.data(), degree, results.data(), count, instructionSet);
+				for (std::size_t i = 0; i < count; i++) {
+					if (results[i] != evaluate(coeffs.data(), degree, elements[i])) {
+						std::cerr << "applyHorner: " << Algebra::Kernel::getInstructionSetName(instructionSet) << " differs at degree "
+							<< degree << ", element " << i << " of " << count << "\n";
+						return false;
+					}
+				}
+			}
+		}
+	}
+	return true;
+}
+
+static bool checkEvaluateColumns(std::mt19937& random) {
+	std::uniform_int_distribution<int> value(INT32_MIN, INT32_MAX);
+	for (int degree = 0; degree <= Algebra::Limits::MAX_SUPPORTED_EXPONENT; degree++) {
+		for (std::size_t count : COUNTS) {
+			std::vector<std::vector<int>> columns(degree + 1, std::vector<int>(count));
+			std::vector<const int*> pointers;
+			for (auto& column : columns) {
+				for (int& c : column)
+					c = value(random);
+				pointers.push_back(column.data());
+			}
+			int x = value(random);
+			for (Algebra::Kernel::InstructionSet instructionSet : INSTRUCTION_SETS) {
+				std::vector<int> results(count);
+				Algebra::Kernel::evaluateColumns(pointers.data(), degree, x, results.data(), count, instructionSet);
+				for (std::size_t p = 0; p < count; p++) {
+					std::vector<int> coeffs(degree + 1);
+					for (int exp = 0; exp <= degree; exp++)
+						coeffs[exp] = columns[exp][p];
+					if (results[p] != evaluate(coeffs.data(), degree, x)) {
+						std::cerr << "evaluateColumns: " << Algebra::Kernel::getInstructionSetName(instructionSet) << " differs at degree "
+							<< degree << ", polynomial " << p << " of " << count << "\n";
+						return false;
+					}
+				}
+			}
+		}
+	}
+	return true;
+}
+
+static Algebra::Polynomial makePolynomial(std::mt19937& random) {
+	std::uniform_int_distribution<int> coefficient(-Algebra::Limits::MAX_COEFFICIENT, Algebra::Limits::MAX_COEFFICIENT);
+	std::uniform_int_distribution<int> constant(-Algebra::Limits::MAX_CONSTANT, Algebra::Limits::MAX_CONSTANT);
+	int coeffs[Algebra::Limits::MAX_EXPONENT + 1];
+	coeffs[0] = constant(random);
+	for (int exp = 1; exp <= Algebra::Limits::MAX_EXPONENT; exp++)
+		coeffs[exp] = coefficient(random);
+	Algebra::Polynomial polynomial;
+	polynomial.setCoefficients(coeffs);
+	return polynomial;
+}
+
+// A set whose size is not a multiple of either lane width must evaluate every polynomial as Polynomial::apply would
+static bool checkEvaluateAt(std::mt19937& random) {
+	std::vector<Algebra::Polynomial> polynomials;
+	for (int i = 0; i < 1003; i++)
+		polynomials.push_back(makePolynomial(random));
+	Algebra::PolynomialSet set(polynomials);
+	std::vector<int> results(set.size());
+	for (int x : { 0, 1, -1, 7, -500, 46341, INT32_MIN }) {
+		set.evaluateAt(x, results);
+		for (std::size_t p = 0; p < polynomials.size(); p++) {
+			int expected = x;
+			polynomials[p].apply(&expected, 1);
+			if (results[p] != expected) {
+				std::cerr << "evaluateAt: \"" << polynomials[p].toString() << "\" at " << x << " gave " << results[p] << ", apply gave " << expected << "\n";
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// 3x^2 - 1 read at the nodes -2, 1, 4, 7 gives 11,2,47,146; only the copies of that polynomial should match
+static bool checkFindMatches(std::mt19937& random) {
+	Algebra::Polynomial target;
+	target.parseFrom("3x^2 - 1");
+	std::vector<Algebra::Polynomial> polynomials;
+	std::vector<unsigned char> expected;
+	for (int i = 0; i < 21; i++) {
+		bool isTarget = i % 5 == 2;
+		polynomials.push_back(isTarget ? target : makePolynomial(random));
+		expected.push_back(isTarget || polynomials.back().toString() == target.toString());
+	}
+	Algebra::PolynomialSet set(polynomials);
+	std::vector<unsigned char> isMatch;
+	std::size_t matches = set.findMatches(Algebra::Sequence({ 11, 2, 47, 146 }), -2, 3, isMatch);
+	if (isMatch != expected || matches != (std::size_t)std::count(expected.begin(), expected.end(), 1)) {
+		std::cerr << "findMatches: found " << matches << " matches, expected only the copies of 3x^2 - 1\n";
+		return false;
+	}
+	return true;
+}
+
+int main() {
+	std::mt19937 random(8501);
+	if (!checkApplyHorner(random) || !checkEvaluateColumns(random) || !checkEvaluateAt(random) || !checkFindMatches(random))
+		return 1;
+	std::cout << "Kernels: " << Algebra::Kernel::getInstructionSetName(Algebra::Kernel::getInstructionSet()) << " and lower agree with scalar evaluation\n";
+	return 0;
+}
@@ -0,0 +1,75 @@
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "sequence_set.h"
+
+// A moved-from set must still be a valid empty set: size() stays 0 and it can be filled again
+static bool checkMovedFrom(Algebra::SequenceSet& set, const char* name) {
+	if (set.size() != 0 || !set.empty() || set.getElementCount() != 0) {
+		std::cerr << name << ": moved-from set reports " << set.size() << " sequences\n";
+		return false;
+	}
+	set.pushBack(std::vector<int>{ 4, 5 });
+	if (set.size() != 1 || set[0].elements.size() != 2) {
+		std::cerr << name << ": moved-from set could not be reused\n";
+		return false;
+	}
+	return true;
+}
+
+static Algebra::SequenceSet makeSet() {
+	Algebra::SequenceSet set;
+	set.pushBack(std::vector<int>{ 1, 2, 3 });
+	set.pushBack(std::vector<int>{ 6 });
+	return set;
+}
+
+// Moves cannot throw, so a growing vector of sets relocates each set's column instead of copying it
+static bool checkRelocation() {
+	std::vector<Algebra::SequenceSet> sets;
+	sets.push_back(makeSet());
+	const int* column = sets[0].getAllElements().data();
+	for (int i = 0; i < 64; i++)
+		sets.emplace_back();
+	if (sets[0].getAllElements().data() != column || sets[0].size() != 2 || !sets.back().empty()) {
+		std::cerr << "relocation: a set was copied, not moved, when the vector grew\n";
+		return false;
+	}
+	return true;
+}
+
+int main() {
+	Algebra::SequenceSet source = makeSet();
+	Algebra::SequenceSet constructed(std::move(source));
+	if (constructed.size() != 2 || !checkMovedFrom(source, "move construction"))
+		return 1;
+
+	Algebra::SequenceSet assigned = makeSet();
+	source = makeSet();
+	assigned = std::move(source);
+	if (assigned.size() != 2 || !checkMovedFrom(source, "move assignment"))
+		return 1;
+
+	Algebra::SequenceSet collected;
+	source = makeSet();
+	collected.append(std::move(source));
+	if (collected.size() != 2 || !checkMovedFrom(source, "append into an empty set"))
+		return 1;
+
+	// A set with no offsets yet must take its leading offset from the first rows copied into it
+	Algebra::SequenceSet empty, copied;
+	const Algebra::SequenceSet rows = makeSet();
+	copied.append(empty);
+	copied.append(rows);
+	if (copied.size() != 2 || copied[1].elements.size() != 1 || copied[1].elements[0] != 6) {
+		std::cerr << "copy into an empty set: got " << copied.size() << " sequences\n";
+		return 1;
+	}
+
+	if (!checkRelocation())
+		return 1;
+
+	std::cout << "SequenceSet: all checks passed\n";
+	return 0;
+}
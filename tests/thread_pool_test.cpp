@@ -0,0 +1,35 @@
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+
+#include "thread_pool.h"
+
+// Dispatches straight after the workers are (re)started, before they are likely to have been scheduled; a worker
+// that misses the first generation leaves parallelFor waiting forever, which ctest reports as a timeout
+static bool runAndCheck(ThreadPool& pool, const char* stage) {
+	const std::size_t taskCount = 100;
+	std::atomic<std::size_t> sum = 0;
+	pool.parallelFor(taskCount, [&](std::size_t i) { sum += i + 1; });
+	if (sum != taskCount * (taskCount + 1) / 2) {
+		std::cerr << stage << ": expected " << taskCount * (taskCount + 1) / 2 << ", got " << sum << "\n";
+		return false;
+	}
+	return true;
+}
+
+int main() {
+	const int rounds = 200;
+	for (int round = 0; round < rounds; round++) {
+		ThreadPool pool(8);
+		if (!runAndCheck(pool, "after construction") || !runAndCheck(pool, "second dispatch"))
+			return 1;
+		pool.setWorkerCount(4);
+		if (!runAndCheck(pool, "after setWorkerCount"))
+			return 1;
+		pool.setWorkerCount(1);
+		if (!runAndCheck(pool, "without workers"))
+			return 1;
+	}
+	std::cout << "ThreadPool: " << rounds << " rounds passed\n";
+	return 0;
+}